@@ -4,6 +4,7 @@
 #define _USE_MATH_DEFINES
 
 #include <TL-Engine.h>	// TL-Engine include file and namespace
+#include "../../Shared/Collision.h" // The collision tests shared with the other games
 #include <string>
 #include <cmath> // Using cmath for C++, rather than math for C.
 #include <vector>
@@ -307,7 +308,7 @@ void CreatePlants(vector<SObject>& plants, I3DEngine& myEngine);
 void RotateCameraUp(const float& frametime, float& currentCameraRotation, IModel* dummy);
 void RotateCameraDown(const float& frametime, float& currentCameraRotation, IModel* dummy);
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it
 	I3DEngine* myEngine = New3DEngine(kTLX);
@@ -636,21 +637,7 @@ bool IsSphereBoxCollided(const SFrog& sphere, const SVehicle& box)
 {
 	// This is a sphere to box collision model.
 	// Slightly inaccurate around corners.
-
-	const float boxX = box.model->GetX();
-	const float boxMaxX = boxX + kBoxRadiusX + kFrogRadius;
-	const float boxMinX = boxX - kBoxRadiusX - kFrogRadius;
-	const float boxZ = box.model->GetZ();
-	const float boxMaxZ = boxZ + kBoxRadiusZ + kFrogRadius;
-	const float boxMinZ = boxZ - kBoxRadiusZ - kFrogRadius;
-
-	const float sphereX = sphere.model->GetX();
-	const float sphereZ = sphere.model->GetZ();
-
-	if (sphereX < boxMaxX && sphereX > boxMinX&& sphereZ < boxMaxZ && sphereZ > boxMinZ)
-		return true;
-	else
-		return false;
+	return IsCollided(SSphereShape{ sphere.model->GetX(), sphere.model->GetZ(), kFrogRadius }, SBoxShape{ box.model->GetX(), box.model->GetZ(), kBoxRadiusX, kBoxRadiusZ });
 }
 
 // End the game
@@ -819,21 +806,7 @@ vector<STyre> CreateTires(I3DEngine& myEngine)
 bool IsSphereSphereCollided(const IModel* sphere1, const IModel* sphere2, const float& kSphere1Radius, const float& kSphere2Radius)
 {
 	// Don't need to check Y Coordinates
-
-	float totalDistance = 0.0f;
-	const float kSphere1X = sphere1->GetX();
-	const float kSphere1Z = sphere1->GetZ();
-
-	const float kSphere2X = sphere2->GetX();
-	const float kSphere2Z = sphere2->GetZ();
-
-	const float kSquared = 2.0f; // Power of 2
-	totalDistance = pow((kSphere2X - kSphere1X), kSquared) + pow((kSphere2Z - kSphere1Z), kSquared);
-
-	if (totalDistance < powf(kSphere2Radius + kSphere1Radius, kSquared))
-		return true;
-	else
-		return false;
+	return IsCollided(SSphereShape{ sphere1->GetX(), sphere1->GetZ(), kSphere1Radius }, SSphereShape{ sphere2->GetX(), sphere2->GetZ(), kSphere2Radius });
 }
 
 // Attach the dummy to a tyre, and move it onto the tyre.
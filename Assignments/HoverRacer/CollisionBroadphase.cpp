@@ -0,0 +1,65 @@
+#include "CollisionBroadphase.h"
+#include <algorithm> // sort
+
+namespace
+{
+	// Up to this many colliders, the hierarchy is faster to query than the grid.
+	constexpr size_t kMaxBvhColliders = 15;
+}
+
+EBroadphaseType ChooseBroadphaseType(const size_t& kColliderCount) noexcept
+{
+	return (kColliderCount <= kMaxBvhColliders) ? EBroadphaseType::bvh : EBroadphaseType::grid;
+}
+
+CCollisionBroadphase::CCollisionBroadphase(const float& kCellSize) : grid_(kCellSize)
+{
+}
+
+void CCollisionBroadphase::Build(const std::vector<SGridBounds>& kBounds)
+{
+	Clear();
+	type_ = ChooseBroadphaseType(kBounds.size());
+	if (type_ == EBroadphaseType::bvh)
+	{
+		bvh_.Build(kBounds);
+	}
+	else
+	{
+		grid_.Build(kBounds);
+	}
+}
+
+void CCollisionBroadphase::Clear() noexcept
+{
+	grid_.Clear();
+	bvh_.Clear();
+}
+
+void CCollisionBroadphase::Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	const size_t kFirst = candidates.size();
+	if (type_ == EBroadphaseType::bvh)
+	{
+		bvh_.Query(kX, kZ, kRadius, candidates);
+	}
+	else
+	{
+		grid_.Query(kX, kZ, kRadius, candidates);
+	}
+	std::sort(candidates.begin() + kFirst, candidates.end());
+}
+
+void CCollisionBroadphase::QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	const size_t kFirst = candidates.size();
+	if (type_ == EBroadphaseType::bvh)
+	{
+		bvh_.QuerySegment(kStartX, kStartZ, kEndX, kEndZ, kRadius, candidates);
+	}
+	else
+	{
+		grid_.QuerySegment(kStartX, kStartZ, kEndX, kEndZ, kRadius, candidates);
+	}
+	std::sort(candidates.begin() + kFirst, candidates.end());
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for collider indices
+#include <vector> // Vector class
+#include "CollisionBvh.h" // CCollisionBvh
+#include "CollisionGrid.h" // CCollisionGrid, SGridBounds
+
+// Finds the colliders near a point or along a path, using a uniform grid or a bounding volume hierarchy.
+// Which one is picked from the number of colliders alone, so the same level always gets the same one. The rule comes
+// from the broadphase timings of Tools/CollisionBenchmark: a handful of colliders fit in a hierarchy a few nodes deep,
+// which beats hashing every grid cell a query covers, but from about 16 colliders upwards the grid is faster.
+// Queries return indices in ascending order whichever is used, so collision is resolved in the same order as before.
+
+enum class EBroadphaseType
+{
+	grid,
+	bvh
+};
+
+// Pick the broadphase for a number of colliders.
+EBroadphaseType ChooseBroadphaseType(const size_t& kColliderCount) noexcept;
+
+class CCollisionBroadphase
+{
+private:
+	CCollisionGrid grid_;
+	CCollisionBvh bvh_;
+	EBroadphaseType type_ = EBroadphaseType::grid;
+
+public:
+	explicit CCollisionBroadphase(const float& kCellSize);
+
+	// Rebuild from the area each collider covers, with the broadphase ChooseBroadphaseType picks for them.
+	void Build(const std::vector<SGridBounds>& kBounds);
+	void Clear() noexcept;
+
+	// Add the indices of the colliders that may overlap a circle to candidates, in ascending order.
+	void Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	// Add the indices of the colliders that may come within kRadius of a segment to candidates, in ascending order.
+	void QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	EBroadphaseType GetType() const noexcept
+	{
+		return type_;
+	}
+};
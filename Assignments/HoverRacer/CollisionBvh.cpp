@@ -0,0 +1,223 @@
+#include "CollisionBvh.h"
+#include <algorithm> // partition, min, max
+#include <array> // Fixed size array of bins
+#include <limits> // maximum data type values
+
+namespace
+{
+	// Centres are binned along an axis to find where to split a node. More bins find better splits but build slower.
+	constexpr uint32_t kSplitBins = 16;
+	// Nodes with this many colliders or fewer are always leaves.
+	constexpr uint32_t kMinSplitColliders = 2;
+	// Nodes with more colliders than this are always split, if their colliders can be split at all.
+	constexpr uint32_t kMaxLeafColliders = 8;
+	// Cost of visiting a node compared to testing one collider.
+	constexpr float kNodeCost = 1.0f;
+
+	SGridBounds GetEmptyBounds() noexcept
+	{
+		constexpr float kMax = std::numeric_limits<float>::max();
+		return { kMax, -kMax, kMax, -kMax };
+	}
+
+	void GrowBounds(SGridBounds& bounds, const SGridBounds& kOther) noexcept
+	{
+		bounds.minX = std::min(bounds.minX, kOther.minX);
+		bounds.maxX = std::max(bounds.maxX, kOther.maxX);
+		bounds.minZ = std::min(bounds.minZ, kOther.minZ);
+		bounds.maxZ = std::max(bounds.maxZ, kOther.maxZ);
+	}
+
+	// The chance of a query hitting an area grows with its perimeter, the 2D equivalent of surface area.
+	// Half the perimeter is used, as only the ratio between areas matters.
+	float GetHalfPerimeter(const SGridBounds& kBounds) noexcept
+	{
+		if (kBounds.minX > kBounds.maxX)
+		{
+			return 0.0f; // Empty
+		}
+		return (kBounds.maxX - kBounds.minX) + (kBounds.maxZ - kBounds.minZ);
+	}
+
+	struct SSplitBin
+	{
+		SGridBounds bounds = GetEmptyBounds();
+		uint32_t count = 0;
+	};
+}
+
+void CCollisionBvh::Build(const std::vector<SGridBounds>& kBounds)
+{
+	Clear();
+	if (kBounds.empty())
+	{
+		return;
+	}
+
+	// Centres are stored doubled (min + max) as x, z pairs, which saves a multiply per collider and sorts the same.
+	std::vector<float> centres(kBounds.size() * 2);
+	indices_.resize(kBounds.size());
+	for (uint32_t i = 0; i < kBounds.size(); i++)
+	{
+		centres[i * 2] = kBounds[i].minX + kBounds[i].maxX;
+		centres[i * 2 + 1] = kBounds[i].minZ + kBounds[i].maxZ;
+		indices_[i] = i;
+	}
+	// A binary tree with one collider per leaf has fewer than twice as many nodes as colliders.
+	nodes_.reserve(kBounds.size() * 2);
+	BuildNode(kBounds, centres, 0, static_cast<uint32_t>(kBounds.size()), 0);
+
+	bounds_.reserve(indices_.size());
+	for (const uint32_t kIndex : indices_)
+	{
+		bounds_.push_back(kBounds[kIndex]);
+	}
+}
+
+void CCollisionBvh::BuildNode(const std::vector<SGridBounds>& kBounds, const std::vector<float>& kCentres, const uint32_t& kFirst, const uint32_t& kCount, const size_t& kDepth)
+{
+	// A query keeps the second child of every node above the one it is in, plus the node itself
+	stack_.resize(std::max(stack_.size(), kDepth + 2));
+	const uint32_t kNode = static_cast<uint32_t>(nodes_.size());
+	nodes_.push_back({ GetEmptyBounds(), kFirst, kCount });
+	SGridBounds centreBounds = GetEmptyBounds();
+	for (uint32_t i = kFirst; i < kFirst + kCount; i++)
+	{
+		const uint32_t kIndex = indices_[i];
+		GrowBounds(nodes_[kNode].bounds, kBounds[kIndex]);
+		GrowBounds(centreBounds, { kCentres[kIndex * 2], kCentres[kIndex * 2], kCentres[kIndex * 2 + 1], kCentres[kIndex * 2 + 1] });
+	}
+	if (kCount <= kMinSplitColliders)
+	{
+		return;
+	}
+
+	// Try splitting at the boundary between every pair of bins on both axes, and keep the cheapest split.
+	// The cost of a child is the number of colliders in it, weighted by the chance of a query reaching it.
+	const float kCentreLow[]{ centreBounds.minX, centreBounds.minZ };
+	const float kCentreHigh[]{ centreBounds.maxX, centreBounds.maxZ };
+	float bestCost = std::numeric_limits<float>::max();
+	int bestAxis = -1;
+	uint32_t bestSplit = 0;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		const float kExtent = kCentreHigh[axis] - kCentreLow[axis];
+		if (kExtent <= 0.0f)
+		{
+			continue; // Every centre is in the same place along this axis
+		}
+		const float kBinScale = kSplitBins / kExtent;
+		std::array<SSplitBin, kSplitBins> bins;
+		for (uint32_t i = kFirst; i < kFirst + kCount; i++)
+		{
+			const uint32_t kIndex = indices_[i];
+			const uint32_t kBin = std::min(kSplitBins - 1, static_cast<uint32_t>((kCentres[kIndex * 2 + axis] - kCentreLow[axis]) * kBinScale));
+			GrowBounds(bins[kBin].bounds, kBounds[kIndex]);
+			bins[kBin].count++;
+		}
+
+		// Sweep from the high side first, so the low side sweep can price each split straight away.
+		std::array<float, kSplitBins> highCosts{};
+		SGridBounds highBounds = GetEmptyBounds();
+		uint32_t highCount = 0;
+		for (uint32_t bin = kSplitBins - 1; bin > 0; bin--)
+		{
+			GrowBounds(highBounds, bins[bin].bounds);
+			highCount += bins[bin].count;
+			highCosts[bin] = highCount * GetHalfPerimeter(highBounds);
+		}
+		SGridBounds lowBounds = GetEmptyBounds();
+		uint32_t lowCount = 0;
+		for (uint32_t split = 1; split < kSplitBins; split++)
+		{
+			GrowBounds(lowBounds, bins[split - 1].bounds);
+			lowCount += bins[split - 1].count;
+			const float kCost = lowCount * GetHalfPerimeter(lowBounds) + highCosts[split];
+			if (lowCount != 0 && lowCount != kCount && kCost < bestCost)
+			{
+				bestCost = kCost;
+				bestAxis = axis;
+				bestSplit = split;
+			}
+		}
+	}
+	if (bestAxis < 0)
+	{
+		return; // Every centre is in the same place, so the colliders cannot be split
+	}
+	const float kNodeArea = GetHalfPerimeter(nodes_[kNode].bounds);
+	if (kCount <= kMaxLeafColliders && kNodeCost * kNodeArea + bestCost >= kCount * kNodeArea)
+	{
+		return; // Testing every collider is cheaper than visiting the children
+	}
+
+	const float kBinScale = kSplitBins / (kCentreHigh[bestAxis] - kCentreLow[bestAxis]);
+	const auto kMiddle = std::partition(indices_.begin() + kFirst, indices_.begin() + kFirst + kCount, [&](const uint32_t& kIndex)
+	{
+		return std::min(kSplitBins - 1, static_cast<uint32_t>((kCentres[kIndex * 2 + bestAxis] - kCentreLow[bestAxis]) * kBinScale)) < bestSplit;
+	});
+	const uint32_t kLowCount = static_cast<uint32_t>(kMiddle - indices_.begin()) - kFirst;
+
+	nodes_[kNode].count = 0;
+	BuildNode(kBounds, kCentres, kFirst, kLowCount, kDepth + 1);
+	nodes_[kNode].first = static_cast<uint32_t>(nodes_.size());
+	BuildNode(kBounds, kCentres, kFirst + kLowCount, kCount - kLowCount, kDepth + 1);
+}
+
+void CCollisionBvh::Clear() noexcept
+{
+	nodes_.clear();
+	indices_.clear();
+	bounds_.clear();
+	stack_.clear();
+}
+
+template <typename Overlaps>
+void CCollisionBvh::Walk(const Overlaps& kOverlaps, std::vector<uint32_t>& candidates) const
+{
+	if (nodes_.empty())
+	{
+		return;
+	}
+	uint32_t* stack = stack_.data();
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+	while (stackSize != 0)
+	{
+		const uint32_t kNodeIndex = stack[--stackSize];
+		const SNode& kNode = nodes_[kNodeIndex];
+		if (!kOverlaps(kNode.bounds))
+		{
+			continue;
+		}
+		if (kNode.count == 0)
+		{
+			stack[stackSize++] = kNode.first;
+			stack[stackSize++] = kNodeIndex + 1;
+			continue;
+		}
+		for (uint32_t i = kNode.first; i < kNode.first + kNode.count; i++)
+		{
+			if (kOverlaps(bounds_[i]))
+			{
+				candidates.push_back(indices_[i]);
+			}
+		}
+	}
+}
+
+void CCollisionBvh::Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	Walk([&](const SGridBounds& kBounds)
+	{
+		return IsCircleInBounds(kBounds, kX, kZ, kRadius);
+	}, candidates);
+}
+
+void CCollisionBvh::QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	Walk([&](const SGridBounds& kBounds)
+	{
+		return IsSegmentInBounds(kBounds, kStartX, kStartZ, kEndX, kEndZ, kRadius);
+	}, candidates);
+}
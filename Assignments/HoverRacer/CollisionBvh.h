@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for node links
+#include <vector> // Vector class
+#include "CollisionGrid.h" // SGridBounds
+
+// Bounding volume hierarchy for the collision broadphase
+// Built once over a level's static colliders. Each node is split where the surface area heuristic expects queries to
+// test the fewest colliders, so dense areas get many small nodes and long empty straights a few big ones.
+// Nodes are stored depth first in one array: a node's first child is the node after it, so queries walk forwards
+// through memory. Each collider is in exactly one leaf, so queries never return a collider twice.
+
+class CCollisionBvh
+{
+private:
+	struct SNode
+	{
+		SGridBounds bounds;
+		uint32_t first; // Leaves: where their colliders start in indices_. Other nodes: the index of the second child.
+		uint32_t count; // Number of colliders in a leaf, 0 for other nodes
+	};
+
+	std::vector<SNode> nodes_;
+	std::vector<uint32_t> indices_; // Collider indices, grouped by leaf
+	std::vector<SGridBounds> bounds_; // The bounds of each collider in indices_, in the same order
+	// Nodes still to visit during a query. Sized when built, so a query never allocates.
+	mutable std::vector<uint32_t> stack_;
+
+	// Build the node for indices_[kFirst, kFirst + kCount) at kDepth. kCentres holds twice the centre of every collider.
+	void BuildNode(const std::vector<SGridBounds>& kBounds, const std::vector<float>& kCentres, const uint32_t& kFirst, const uint32_t& kCount, const size_t& kDepth);
+
+	// Visit every leaf collider whose bounds pass kOverlaps, and add its index to candidates.
+	template <typename Overlaps>
+	void Walk(const Overlaps& kOverlaps, std::vector<uint32_t>& candidates) const;
+
+public:
+	// Rebuild the hierarchy. kBounds[i] is the area collider i covers.
+	void Build(const std::vector<SGridBounds>& kBounds);
+	void Clear() noexcept;
+
+	// Add the indices of the colliders whose bounds overlap a circle to candidates.
+	void Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	// Add the indices of the colliders whose bounds come within kRadius of a segment to candidates.
+	void QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	size_t GetNodeCount() const noexcept
+	{
+		return nodes_.size();
+	}
+};
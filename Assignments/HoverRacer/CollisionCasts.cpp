@@ -0,0 +1,162 @@
+#include "CollisionCasts.h"
+#include <algorithm> // min, max
+#include <cmath> // sqrtf
+#include "ContactManifold.h" // GetCircleContact
+
+namespace
+{
+	// The sweep grows a box by the cast's radius along the box's own axes. At the corners of a turned box that reaches
+	// up to the square root of 2 times the radius past the box's bounds, so boxes are looked for that much further out.
+	constexpr float kBoxReach = 1.41421356f;
+
+	// The area a cast's circle passes over, with room for the corners of turned boxes
+	SGridBounds GetCastBounds(const SCast& kCast) noexcept
+	{
+		const float kRadius = kCast.radius * kBoxReach;
+		return { std::min(kCast.startX, kCast.endX) - kRadius, std::max(kCast.startX, kCast.endX) + kRadius,
+			std::min(kCast.startZ, kCast.endZ) - kRadius, std::max(kCast.startZ, kCast.endZ) + kRadius };
+	}
+}
+
+SCast GetRayCast(const float& kX, const float& kZ, const float& kDirectionX, const float& kDirectionZ, const float& kLength) noexcept
+{
+	const float kDirectionLength = sqrtf(kDirectionX * kDirectionX + kDirectionZ * kDirectionZ);
+	if (kDirectionLength == 0.0f)
+	{
+		return { kX, kZ, kX, kZ, 0.0f };
+	}
+	const float kScale = kLength / kDirectionLength;
+	return { kX, kZ, kX + kDirectionX * kScale, kZ + kDirectionZ * kScale, 0.0f };
+}
+
+CSceneryCaster::CSceneryCaster(const CStaticColliders& kBoxes, const CCollisionBroadphase& kBoxBroadphase, const CStaticColliders& kSpheres, const CCollisionBroadphase& kSphereBroadphase, const CStaticColliders& kStruts, const CCollisionBroadphase& kCheckpointBroadphase)
+	: boxes_(kBoxes), boxBroadphase_(kBoxBroadphase), spheres_(kSpheres), sphereBroadphase_(kSphereBroadphase), struts_(kStruts), checkpointBroadphase_(kCheckpointBroadphase)
+{
+}
+
+void CSceneryCaster::FindCandidates(const SCast& kCast)
+{
+	boxCandidates_.clear();
+	sphereCandidates_.clear();
+	checkpointCandidates_.clear();
+	boxBroadphase_.QuerySegment(kCast.startX, kCast.startZ, kCast.endX, kCast.endZ, kCast.radius * kBoxReach, boxCandidates_);
+	sphereBroadphase_.QuerySegment(kCast.startX, kCast.startZ, kCast.endX, kCast.endZ, kCast.radius, sphereCandidates_);
+	checkpointBroadphase_.QuerySegment(kCast.startX, kCast.startZ, kCast.endX, kCast.endZ, kCast.radius, checkpointCandidates_);
+	FindStruts();
+}
+
+void CSceneryCaster::FindCandidates(const float& kX, const float& kZ, const float& kRadius)
+{
+	boxCandidates_.clear();
+	sphereCandidates_.clear();
+	checkpointCandidates_.clear();
+	boxBroadphase_.Query(kX, kZ, kRadius, boxCandidates_);
+	sphereBroadphase_.Query(kX, kZ, kRadius, sphereCandidates_);
+	checkpointBroadphase_.Query(kX, kZ, kRadius, checkpointCandidates_);
+	FindStruts();
+}
+
+void CSceneryCaster::FindStruts()
+{
+	// Checkpoints come out in ascending order, so their struts do too
+	strutCandidates_.clear();
+	for (const uint32_t kCheckpoint : checkpointCandidates_)
+	{
+		if (2 * static_cast<size_t>(kCheckpoint) + 1 < struts_.GetCount())
+		{
+			strutCandidates_.push_back(2 * kCheckpoint);
+			strutCandidates_.push_back(2 * kCheckpoint + 1);
+		}
+	}
+}
+
+SCastHit CSceneryCaster::TestCandidates(const SCast& kCast) const noexcept
+{
+	const float kMoveX = kCast.endX - kCast.startX;
+	const float kMoveZ = kCast.endZ - kCast.startZ;
+	SCastHit hit{ ECastTarget::none, 0, 1.0f, kCast.endX, kCast.endZ, 0.0f, 0.0f };
+	bool isXAxis = false;
+
+	// Boxes are tested first, so a box and a sphere hit at the same time count as the box
+	const SBoxSweep kBox = SweepCircleBoxes(boxes_, boxCandidates_.data(), boxCandidates_.size(), kCast.startX, kCast.startZ, kMoveX, kMoveZ, kCast.radius);
+	if (kBox.position != boxCandidates_.size())
+	{
+		hit.target = ECastTarget::box;
+		hit.index = boxCandidates_[kBox.position];
+		hit.time = kBox.time;
+		isXAxis = kBox.xAxis;
+	}
+	const SSphereSweep kSphere = SweepCircleSpheres(spheres_, sphereCandidates_.data(), sphereCandidates_.size(), kCast.startX, kCast.startZ, kMoveX, kMoveZ, kCast.radius);
+	if (kSphere.position != sphereCandidates_.size() && (hit.target == ECastTarget::none || kSphere.time < hit.time))
+	{
+		hit.target = ECastTarget::sphere;
+		hit.index = sphereCandidates_[kSphere.position];
+		hit.time = kSphere.time;
+	}
+	const SSphereSweep kStrut = SweepCircleSpheres(struts_, strutCandidates_.data(), strutCandidates_.size(), kCast.startX, kCast.startZ, kMoveX, kMoveZ, kCast.radius);
+	if (kStrut.position != strutCandidates_.size() && (hit.target == ECastTarget::none || kStrut.time < hit.time))
+	{
+		hit.target = ECastTarget::strut;
+		hit.index = strutCandidates_[kStrut.position];
+		hit.time = kStrut.time;
+	}
+
+	if (hit.target == ECastTarget::none)
+	{
+		return hit;
+	}
+	hit.x = kCast.startX + kMoveX * hit.time;
+	hit.z = kCast.startZ + kMoveZ * hit.time;
+	// The surface faces the same way as the push out of a contact there
+	const CStaticColliders& kSpheres = (hit.target == ECastTarget::strut) ? struts_ : spheres_;
+	const SContact kContact = (hit.target == ECastTarget::box) ? GetBoxContact(boxes_, hit.index, hit.x, hit.z, kCast.radius, isXAxis)
+		: GetCircleContact(hit.x, hit.z, kCast.radius, kSpheres.GetX()[hit.index], kSpheres.GetZ()[hit.index], kSpheres.GetRadius()[hit.index]);
+	hit.normalX = kContact.normalX;
+	hit.normalZ = kContact.normalZ;
+	return hit;
+}
+
+SCastHit CSceneryCaster::Cast(const SCast& kCast)
+{
+	FindCandidates(kCast);
+	return TestCandidates(kCast);
+}
+
+void CSceneryCaster::Cast(const SCast* kCasts, const size_t& kCount, SCastHit* hits)
+{
+	size_t first = 0;
+	while (first < kCount)
+	{
+		// Group the casts that follow while their paths fit in kCastBatchSpan
+		SGridBounds bounds = GetCastBounds(kCasts[first]);
+		size_t last = first + 1;
+		for (; last < kCount; last++)
+		{
+			const SGridBounds kCastBounds = GetCastBounds(kCasts[last]);
+			const SGridBounds kGroupBounds{ std::min(bounds.minX, kCastBounds.minX), std::max(bounds.maxX, kCastBounds.maxX),
+				std::min(bounds.minZ, kCastBounds.minZ), std::max(bounds.maxZ, kCastBounds.maxZ) };
+			if (kGroupBounds.maxX - kGroupBounds.minX > kCastBatchSpan || kGroupBounds.maxZ - kGroupBounds.minZ > kCastBatchSpan)
+			{
+				break;
+			}
+			bounds = kGroupBounds;
+		}
+
+		// A cast on its own is queried along its path. A group is queried once, with a circle around all of it.
+		if (last - first == 1)
+		{
+			FindCandidates(kCasts[first]);
+		}
+		else
+		{
+			const float kHalfWidth = (bounds.maxX - bounds.minX) / 2.0f;
+			const float kHalfLength = (bounds.maxZ - bounds.minZ) / 2.0f;
+			FindCandidates(bounds.minX + kHalfWidth, bounds.minZ + kHalfLength, sqrtf(kHalfWidth * kHalfWidth + kHalfLength * kHalfLength));
+		}
+		for (size_t i = first; i < last; i++)
+		{
+			hits[i] = TestCandidates(kCasts[i]);
+		}
+		first = last;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for collider indices
+#include <vector> // Vector class
+#include "CollisionBroadphase.h" // CCollisionBroadphase
+#include "StaticColliders.h" // CStaticColliders
+
+// Casts against the static scenery of a level: what does a ray, a segment or a fat segment hit first?
+// A cast is a circle moved along a straight line. Rays and segments have a radius of 0; a fat segment has the radius of
+// whatever is being moved, eg. a car or the camera. Each cast only tests the colliders the level's broadphases find
+// along its path, the same broadphases collision uses, so a cast costs a handful of tests however big the level is.
+// A batch of casts that lie close together, such as a fan of lookahead rays from one car, shares one broadphase query.
+// Colliders a cast starts inside are not hit, the same as the sweeps in StaticColliders.h.
+
+// Casts in a batch whose paths all fit in a square this size share one broadphase query
+constexpr float kCastBatchSpan = 40.0f;
+
+enum class ECastTarget
+{
+	none, // Nothing was hit
+	box, // An isle or wall
+	sphere, // A water tank
+	strut // A checkpoint strut
+};
+
+// A circle moved from a start to an end
+struct SCast
+{
+	float startX;
+	float startZ;
+	float endX;
+	float endZ;
+	float radius; // 0 for a ray or segment
+};
+
+// Make a cast of a ray from a point, in a direction, that stops kLength along it. The direction doesn't need to be a
+// unit vector.
+SCast GetRayCast(const float& kX, const float& kZ, const float& kDirectionX, const float& kDirectionZ, const float& kLength) noexcept;
+
+// The first thing a cast hits
+struct SCastHit
+{
+	ECastTarget target;
+	uint32_t index; // The collider hit, in its CStaticColliders. The struts of checkpoint i are 2 * i and 2 * i + 1.
+	float time; // How far along the cast the circle first touches the collider, from 0 at the start to 1 at the end
+	float x; // Where the middle of the circle is when it touches. The end of the cast if nothing was hit.
+	float z;
+	float normalX; // The direction the surface touched faces, as a unit vector. 0, 0 if nothing was hit.
+	float normalZ;
+};
+
+class CSceneryCaster
+{
+private:
+	const CStaticColliders& boxes_;
+	const CCollisionBroadphase& boxBroadphase_;
+	const CStaticColliders& spheres_;
+	const CCollisionBroadphase& sphereBroadphase_;
+	const CStaticColliders& struts_; // Two per checkpoint, in checkpoint order
+	const CCollisionBroadphase& checkpointBroadphase_; // Lists checkpoints by the area they and their struts cover
+	std::vector<uint32_t> boxCandidates_;
+	std::vector<uint32_t> sphereCandidates_;
+	std::vector<uint32_t> checkpointCandidates_;
+	std::vector<uint32_t> strutCandidates_;
+
+	// Find the candidates along a cast, or within kRadius of a point for a batch
+	void FindCandidates(const SCast& kCast);
+	void FindCandidates(const float& kX, const float& kZ, const float& kRadius);
+	// Turn the checkpoints found in the checkpoint broadphase into their struts
+	void FindStruts();
+	// Test a cast against the candidates found
+	SCastHit TestCandidates(const SCast& kCast) const noexcept;
+
+public:
+	// The colliders and broadphases are kept by reference, so a caster made once stays up to date as levels are loaded.
+	CSceneryCaster(const CStaticColliders& kBoxes, const CCollisionBroadphase& kBoxBroadphase, const CStaticColliders& kSpheres, const CCollisionBroadphase& kSphereBroadphase, const CStaticColliders& kStruts, const CCollisionBroadphase& kCheckpointBroadphase);
+
+	// Find the first collider a cast hits.
+	SCastHit Cast(const SCast& kCast);
+	// Find the first collider each of a batch of casts hits. hits must have room for kCount results.
+	void Cast(const SCast* kCasts, const size_t& kCount, SCastHit* hits);
+};
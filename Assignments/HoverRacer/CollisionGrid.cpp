@@ -0,0 +1,118 @@
+#include "CollisionGrid.h"
+#include <algorithm> // fill, min, max
+#include <cmath> // floor
+#include "LevelSectors.h" // GetSectorKey
+
+CCollisionGrid::CCollisionGrid(const float& kCellSize) : cellSize_(kCellSize)
+{
+}
+
+int CCollisionGrid::GetCell(const float& kCoordinate) const noexcept
+{
+	return static_cast<int>(std::floor(kCoordinate / cellSize_));
+}
+
+void CCollisionGrid::Build(const std::vector<SGridBounds>& kBounds)
+{
+	Clear();
+
+	// Count the colliders in each cell, then give each cell its own range.
+	for (const SGridBounds& kBound : kBounds)
+	{
+		for (int cellX = GetCell(kBound.minX); cellX <= GetCell(kBound.maxX); cellX++)
+		{
+			for (int cellZ = GetCell(kBound.minZ); cellZ <= GetCell(kBound.maxZ); cellZ++)
+			{
+				cells_[GetSectorKey(cellX, cellZ)].count++;
+			}
+		}
+	}
+	uint32_t nextFirst = 0;
+	for (auto& cell : cells_)
+	{
+		cell.second.first = nextFirst;
+		nextFirst += cell.second.count;
+		cell.second.count = 0;
+	}
+
+	indices_.resize(nextFirst);
+	for (uint32_t i = 0; i < kBounds.size(); i++)
+	{
+		for (int cellX = GetCell(kBounds[i].minX); cellX <= GetCell(kBounds[i].maxX); cellX++)
+		{
+			for (int cellZ = GetCell(kBounds[i].minZ); cellZ <= GetCell(kBounds[i].maxZ); cellZ++)
+			{
+				SCellRange& range = cells_[GetSectorKey(cellX, cellZ)];
+				indices_[range.first + range.count] = i;
+				range.count++;
+			}
+		}
+	}
+	queryStamps_.assign(kBounds.size(), 0);
+	queryStamp_ = 0;
+}
+
+void CCollisionGrid::Clear() noexcept
+{
+	indices_.clear();
+	cells_.clear();
+	queryStamps_.clear();
+}
+
+void CCollisionGrid::BeginQuery() const noexcept
+{
+	queryStamp_++;
+	if (queryStamp_ == 0)
+	{
+		// The stamp wrapped around, so old stamps could match again
+		std::fill(queryStamps_.begin(), queryStamps_.end(), 0);
+		queryStamp_ = 1;
+	}
+}
+
+void CCollisionGrid::AddCell(const int& kCellX, const int& kCellZ, std::vector<uint32_t>& candidates) const
+{
+	const auto kCell = cells_.find(GetSectorKey(kCellX, kCellZ));
+	if (kCell == cells_.end())
+	{
+		return;
+	}
+	for (uint32_t i = kCell->second.first; i < kCell->second.first + kCell->second.count; i++)
+	{
+		const uint32_t kIndex = indices_[i];
+		if (queryStamps_[kIndex] != queryStamp_)
+		{
+			queryStamps_[kIndex] = queryStamp_;
+			candidates.push_back(kIndex);
+		}
+	}
+}
+
+void CCollisionGrid::Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	BeginQuery();
+	for (int cellX = GetCell(kX - kRadius); cellX <= GetCell(kX + kRadius); cellX++)
+	{
+		for (int cellZ = GetCell(kZ - kRadius); cellZ <= GetCell(kZ + kRadius); cellZ++)
+		{
+			AddCell(cellX, cellZ, candidates);
+		}
+	}
+}
+
+void CCollisionGrid::QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const
+{
+	BeginQuery();
+	// Of the cells around the segment, only visit the ones it passes within kRadius of.
+	for (int cellX = GetCell(std::min(kStartX, kEndX) - kRadius); cellX <= GetCell(std::max(kStartX, kEndX) + kRadius); cellX++)
+	{
+		for (int cellZ = GetCell(std::min(kStartZ, kEndZ) - kRadius); cellZ <= GetCell(std::max(kStartZ, kEndZ) + kRadius); cellZ++)
+		{
+			const SGridBounds kCellBounds{ cellX * cellSize_, (cellX + 1) * cellSize_, cellZ * cellSize_, (cellZ + 1) * cellSize_ };
+			if (IsSegmentInBounds(kCellBounds, kStartX, kStartZ, kEndX, kEndZ, kRadius))
+			{
+				AddCell(cellX, cellZ, candidates);
+			}
+		}
+	}
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm> // min, max, swap
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for cell keys
+#include <unordered_map> // Cell lookup
+#include <vector> // Vector class
+
+// Uniform hash grid for the collision broadphase
+// Colliders are listed in every cell their bounds overlap, so long merged walls are found from any cell along them.
+// The indices of each cell's colliders are stored next to each other, and a query only touches the cells around the
+// area asked about, however many colliders the level has. The cell size is separate from the streaming grid, so it can
+// be made smaller for dense tracks.
+
+// The area a collider covers on the ground
+struct SGridBounds
+{
+	float minX;
+	float maxX;
+	float minZ;
+	float maxZ;
+};
+
+// Check if a circle overlaps an area.
+inline bool IsCircleInBounds(const SGridBounds& kBounds, const float& kX, const float& kZ, const float& kRadius) noexcept
+{
+	const float kDistanceX = kX - std::max(kBounds.minX, std::min(kX, kBounds.maxX));
+	const float kDistanceZ = kZ - std::max(kBounds.minZ, std::min(kZ, kBounds.maxZ));
+	return kDistanceX * kDistanceX + kDistanceZ * kDistanceZ <= kRadius * kRadius;
+}
+
+// Check if a segment comes within kRadius of an area. The area is grown by kRadius on every side, so a segment
+// passing just outside a corner can be reported too; that only adds a candidate, never loses one.
+inline bool IsSegmentInBounds(const SGridBounds& kBounds, const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius) noexcept
+{
+	const float kStart[]{ kStartX, kStartZ };
+	const float kDelta[]{ kEndX - kStartX, kEndZ - kStartZ };
+	const float kLow[]{ kBounds.minX - kRadius, kBounds.minZ - kRadius };
+	const float kHigh[]{ kBounds.maxX + kRadius, kBounds.maxZ + kRadius };
+	// Clip the segment to the slab between the low and high side on each axis
+	float enter = 0.0f;
+	float leave = 1.0f;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		if (kDelta[axis] == 0.0f)
+		{
+			if (kStart[axis] < kLow[axis] || kStart[axis] > kHigh[axis])
+			{
+				return false;
+			}
+			continue;
+		}
+		float low = (kLow[axis] - kStart[axis]) / kDelta[axis];
+		float high = (kHigh[axis] - kStart[axis]) / kDelta[axis];
+		if (low > high)
+		{
+			std::swap(low, high);
+		}
+		enter = std::max(enter, low);
+		leave = std::min(leave, high);
+		if (enter > leave)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+class CCollisionGrid
+{
+private:
+	// Where the colliders of one cell are in indices_
+	struct SCellRange
+	{
+		uint32_t first;
+		uint32_t count;
+	};
+
+	float cellSize_;
+	std::vector<uint32_t> indices_; // Collider indices, grouped by cell
+	std::unordered_map<uint64_t, SCellRange> cells_;
+	// A collider in several of the cells a query covers is only added once. Each query gets a new stamp, and
+	// queryStamps_ holds the last query each collider was added by.
+	mutable std::vector<uint32_t> queryStamps_;
+	mutable uint32_t queryStamp_ = 0;
+
+	int GetCell(const float& kCoordinate) const noexcept;
+	// Start a new query, so colliders added by earlier queries can be added again.
+	void BeginQuery() const noexcept;
+	// Add the colliders of a cell that this query has not added yet.
+	void AddCell(const int& kCellX, const int& kCellZ, std::vector<uint32_t>& candidates) const;
+
+public:
+	explicit CCollisionGrid(const float& kCellSize);
+
+	// Rebuild the grid. kBounds[i] is the area collider i covers.
+	void Build(const std::vector<SGridBounds>& kBounds);
+	void Clear() noexcept;
+
+	// Add the indices of the colliders whose cells overlap a circle to candidates. Each collider is added once.
+	void Query(const float& kX, const float& kZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	// Add the indices of the colliders whose cells come within kRadius of a segment to candidates. Each collider is added once.
+	void QuerySegment(const float& kStartX, const float& kStartZ, const float& kEndX, const float& kEndZ, const float& kRadius, std::vector<uint32_t>& candidates) const;
+	float GetCellSize() const noexcept
+	{
+		return cellSize_;
+	}
+	size_t GetCellCount() const noexcept
+	{
+		return cells_.size();
+	}
+};
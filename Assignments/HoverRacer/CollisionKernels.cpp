@@ -0,0 +1,445 @@
+#include "CollisionKernels.h"
+
+// The SSE2 and AVX2 kernels are only built for x86 CPUs. Other CPUs use the scalar kernels.
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define COLLISION_KERNELS_X86
+#include <immintrin.h> // SSE2 and AVX2 intrinsics
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid, _xgetbv
+#endif
+#endif
+
+// GCC and Clang only allow the intrinsics of an instruction set in functions marked as using it.
+// Visual Studio allows them anywhere, so the marks are left empty.
+#if defined(COLLISION_KERNELS_X86) && defined(__GNUC__)
+#define COLLISION_TARGET_SSE2 __attribute__((target("sse2")))
+#define COLLISION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define COLLISION_TARGET_SSE2
+#define COLLISION_TARGET_AVX2
+#endif
+
+namespace
+{
+	using SphereBoxKernel = SBoxHits (*)(const CStaticColliders&, const uint32_t*, const size_t&, const float&, const float&, const float&, const float&, const float&);
+	using SphereSphereKernel = uint32_t (*)(const CStaticColliders&, const uint32_t*, const size_t&, const float&, const float&, const float&);
+	using PointBoxKernel = uint32_t (*)(const CStaticColliders&, const uint32_t*, const size_t&, const float&, const float&);
+
+	struct SKernelSet
+	{
+		SphereBoxKernel sphereBoxes;
+		SphereSphereKernel sphereSpheres;
+		PointBoxKernel pointBoxes;
+	};
+
+	// Scalar kernels, using the shared collision tests. The other kernels give the same results.
+
+	// A box collider in its own axes
+	SBoxShape GetLocalBoxShape(const CStaticColliders& kColliders, const uint32_t& kIndex) noexcept
+	{
+		return { kColliders.GetLocalX()[kIndex], kColliders.GetLocalZ()[kIndex], kColliders.GetHalfWidth()[kIndex], kColliders.GetHalfLength()[kIndex] };
+	}
+
+	SBoxHits TestSphereBoxesScalar(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kPreviousX, const float& kPreviousZ, const float& kRadius)
+	{
+		SBoxHits result{ 0, 0 };
+		for (size_t i = 0; i < kCount; i++)
+		{
+			const uint32_t kIndex = kCandidates[i];
+			const float kAxisX = kColliders.GetAxisX()[kIndex];
+			const float kAxisZ = kColliders.GetAxisZ()[kIndex];
+			const SBoxShape kBox = GetLocalBoxShape(kColliders, kIndex);
+			if (IsCollided(SSphereShape{ GetBoxLocalX(kAxisX, kAxisZ, kX, kZ), GetBoxLocalZ(kAxisX, kAxisZ, kX, kZ), kRadius }, kBox))
+			{
+				result.hits |= 1u << i;
+				// Only the box's own x axis is checked, the same as IsSphereBoxCollided
+				const float kPreviousLocalX = GetBoxLocalX(kAxisX, kAxisZ, kPreviousX, kPreviousZ);
+				if (kPreviousLocalX < kBox.x - kBox.halfWidth - kRadius || kPreviousLocalX > kBox.x + kBox.halfWidth + kRadius)
+				{
+					result.xAxis |= 1u << i;
+				}
+			}
+		}
+		return result;
+	}
+
+	uint32_t TestSphereSpheresScalar(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius)
+	{
+		uint32_t hits = 0;
+		for (size_t i = 0; i < kCount; i++)
+		{
+			const uint32_t kIndex = kCandidates[i];
+			if (IsCollided(SSphereShape{ kX, kZ, kRadius }, SSphereShape{ kColliders.GetX()[kIndex], kColliders.GetZ()[kIndex], kColliders.GetRadius()[kIndex] }))
+			{
+				hits |= 1u << i;
+			}
+		}
+		return hits;
+	}
+
+	uint32_t TestPointBoxesScalar(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ)
+	{
+		uint32_t hits = 0;
+		for (size_t i = 0; i < kCount; i++)
+		{
+			const uint32_t kIndex = kCandidates[i];
+			const float kAxisX = kColliders.GetAxisX()[kIndex];
+			const float kAxisZ = kColliders.GetAxisZ()[kIndex];
+			if (IsCollided(SPointShape{ GetBoxLocalX(kAxisX, kAxisZ, kX, kZ), GetBoxLocalZ(kAxisX, kAxisZ, kX, kZ) }, GetLocalBoxShape(kColliders, kIndex)))
+			{
+				hits |= 1u << i;
+			}
+		}
+		return hits;
+	}
+
+	constexpr SKernelSet kScalarKernels{ TestSphereBoxesScalar, TestSphereSpheresScalar, TestPointBoxesScalar };
+
+#ifdef COLLISION_KERNELS_X86
+	// Mask of the bits of a batch of kCount colliders
+	uint32_t GetBatchMask(const size_t& kCount) noexcept
+	{
+		return static_cast<uint32_t>((1ull << kCount) - 1);
+	}
+
+	// Check if the candidates are a run of neighbouring colliders, eg. every collider of a level. A run is loaded
+	// straight from the collider arrays instead of one lane at a time. Candidates are in ascending order, so this only
+	// needs the ends.
+	bool IsRun(const uint32_t* kCandidates, const size_t& kCount) noexcept
+	{
+		return kCount != 0 && kCandidates[kCount - 1] - kCandidates[0] == kCount - 1;
+	}
+
+	// SSE2 kernels: 4 colliders per instruction. SSE2 has no gather, so colliders that aren't a run are loaded a lane at a time.
+
+	// Load one field of 4 candidates from position kFirst. Lanes past the end of the batch load the first lane again,
+	// and their bits are masked off.
+	COLLISION_TARGET_SSE2 __m128 LoadSse2(const float* kValues, const uint32_t* kCandidates, const size_t& kFirst, const size_t& kCount, const bool& kIsRun) noexcept
+	{
+		const uint32_t* kLanes = kCandidates + kFirst;
+		if (kFirst + 4 <= kCount)
+		{
+			if (kIsRun)
+			{
+				return _mm_loadu_ps(kValues + kLanes[0]);
+			}
+			return _mm_set_ps(kValues[kLanes[3]], kValues[kLanes[2]], kValues[kLanes[1]], kValues[kLanes[0]]);
+		}
+		const size_t kLaneCount = kCount - kFirst;
+		return _mm_set_ps(kValues[kLanes[(kLaneCount > 3) ? 3 : 0]], kValues[kLanes[(kLaneCount > 2) ? 2 : 0]], kValues[kLanes[(kLaneCount > 1) ? 1 : 0]], kValues[kLanes[0]]);
+	}
+
+	// Turn a point into the own axes of 4 boxes, the same way as GetBoxLocalX and GetBoxLocalZ
+	COLLISION_TARGET_SSE2 __m128 GetBoxLocalXSse2(const __m128& kAxisX, const __m128& kAxisZ, const __m128& kX, const __m128& kZ) noexcept
+	{
+		return _mm_add_ps(_mm_mul_ps(kX, kAxisX), _mm_mul_ps(kZ, kAxisZ));
+	}
+	COLLISION_TARGET_SSE2 __m128 GetBoxLocalZSse2(const __m128& kAxisX, const __m128& kAxisZ, const __m128& kX, const __m128& kZ) noexcept
+	{
+		return _mm_sub_ps(_mm_mul_ps(kZ, kAxisX), _mm_mul_ps(kX, kAxisZ));
+	}
+
+	COLLISION_TARGET_SSE2 SBoxHits TestSphereBoxesSse2(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kPreviousX, const float& kPreviousZ, const float& kRadius)
+	{
+		const bool kIsRun = IsRun(kCandidates, kCount);
+		const __m128 kSphereX = _mm_set1_ps(kX);
+		const __m128 kSphereZ = _mm_set1_ps(kZ);
+		const __m128 kSpherePreviousX = _mm_set1_ps(kPreviousX);
+		const __m128 kSpherePreviousZ = _mm_set1_ps(kPreviousZ);
+		const __m128 kSphereRadius = _mm_set1_ps(kRadius);
+		SBoxHits result{ 0, 0 };
+		for (size_t first = 0; first < kCount; first += 4)
+		{
+			const __m128 kAxisX = LoadSse2(kColliders.GetAxisX(), kCandidates, first, kCount, kIsRun);
+			const __m128 kAxisZ = LoadSse2(kColliders.GetAxisZ(), kCandidates, first, kCount, kIsRun);
+			const __m128 kLocalX = GetBoxLocalXSse2(kAxisX, kAxisZ, kSphereX, kSphereZ);
+			const __m128 kLocalZ = GetBoxLocalZSse2(kAxisX, kAxisZ, kSphereX, kSphereZ);
+			const __m128 kPreviousLocalX = GetBoxLocalXSse2(kAxisX, kAxisZ, kSpherePreviousX, kSpherePreviousZ);
+			const __m128 kBoxX = LoadSse2(kColliders.GetLocalX(), kCandidates, first, kCount, kIsRun);
+			const __m128 kBoxZ = LoadSse2(kColliders.GetLocalZ(), kCandidates, first, kCount, kIsRun);
+			const __m128 kHalfWidth = LoadSse2(kColliders.GetHalfWidth(), kCandidates, first, kCount, kIsRun);
+			const __m128 kHalfLength = LoadSse2(kColliders.GetHalfLength(), kCandidates, first, kCount, kIsRun);
+			const __m128 kMaxX = _mm_add_ps(_mm_add_ps(kBoxX, kHalfWidth), kSphereRadius);
+			const __m128 kMinX = _mm_sub_ps(_mm_sub_ps(kBoxX, kHalfWidth), kSphereRadius);
+			const __m128 kMaxZ = _mm_add_ps(_mm_add_ps(kBoxZ, kHalfLength), kSphereRadius);
+			const __m128 kMinZ = _mm_sub_ps(_mm_sub_ps(kBoxZ, kHalfLength), kSphereRadius);
+			const __m128 kHit = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(kLocalX, kMaxX), _mm_cmpgt_ps(kLocalX, kMinX)), _mm_and_ps(_mm_cmplt_ps(kLocalZ, kMaxZ), _mm_cmpgt_ps(kLocalZ, kMinZ)));
+			const __m128 kXAxis = _mm_or_ps(_mm_cmplt_ps(kPreviousLocalX, kMinX), _mm_cmpgt_ps(kPreviousLocalX, kMaxX));
+			result.hits |= static_cast<uint32_t>(_mm_movemask_ps(kHit)) << first;
+			result.xAxis |= static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(kHit, kXAxis))) << first;
+		}
+		result.hits &= GetBatchMask(kCount);
+		result.xAxis &= GetBatchMask(kCount);
+		return result;
+	}
+
+	COLLISION_TARGET_SSE2 uint32_t TestPointBoxesSse2(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ)
+	{
+		const bool kIsRun = IsRun(kCandidates, kCount);
+		const __m128 kPointX = _mm_set1_ps(kX);
+		const __m128 kPointZ = _mm_set1_ps(kZ);
+		uint32_t hits = 0;
+		for (size_t first = 0; first < kCount; first += 4)
+		{
+			const __m128 kAxisX = LoadSse2(kColliders.GetAxisX(), kCandidates, first, kCount, kIsRun);
+			const __m128 kAxisZ = LoadSse2(kColliders.GetAxisZ(), kCandidates, first, kCount, kIsRun);
+			const __m128 kLocalX = GetBoxLocalXSse2(kAxisX, kAxisZ, kPointX, kPointZ);
+			const __m128 kLocalZ = GetBoxLocalZSse2(kAxisX, kAxisZ, kPointX, kPointZ);
+			const __m128 kBoxX = LoadSse2(kColliders.GetLocalX(), kCandidates, first, kCount, kIsRun);
+			const __m128 kBoxZ = LoadSse2(kColliders.GetLocalZ(), kCandidates, first, kCount, kIsRun);
+			const __m128 kHalfWidth = LoadSse2(kColliders.GetHalfWidth(), kCandidates, first, kCount, kIsRun);
+			const __m128 kHalfLength = LoadSse2(kColliders.GetHalfLength(), kCandidates, first, kCount, kIsRun);
+			const __m128 kInsideX = _mm_and_ps(_mm_cmpgt_ps(kLocalX, _mm_sub_ps(kBoxX, kHalfWidth)), _mm_cmplt_ps(kLocalX, _mm_add_ps(kBoxX, kHalfWidth)));
+			const __m128 kInsideZ = _mm_and_ps(_mm_cmpgt_ps(kLocalZ, _mm_sub_ps(kBoxZ, kHalfLength)), _mm_cmplt_ps(kLocalZ, _mm_add_ps(kBoxZ, kHalfLength)));
+			hits |= static_cast<uint32_t>(_mm_movemask_ps(_mm_and_ps(kInsideX, kInsideZ))) << first;
+		}
+		return hits & GetBatchMask(kCount);
+	}
+
+	// AVX2 kernels: 8 colliders per instruction. Lanes past the end of the batch are masked off when loading, so
+	// nothing past the end of the candidates or the collider arrays is read.
+
+	// The lanes of 8 candidates from position kFirst, and their indices
+	struct SAvx2Lanes
+	{
+		__m256i mask; // All bits set in the lanes in the batch
+		__m256i indices;
+		int32_t runStart; // The first collider of the lanes if the batch is a run, otherwise -1
+	};
+
+	COLLISION_TARGET_AVX2 SAvx2Lanes GetLanesAvx2(const uint32_t* kCandidates, const size_t& kFirst, const size_t& kCount, const bool& kIsRun) noexcept
+	{
+		SAvx2Lanes lanes;
+		lanes.mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int32_t>(kCount - kFirst)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+		lanes.indices = _mm256_maskload_epi32(reinterpret_cast<const int*>(kCandidates + kFirst), lanes.mask);
+		lanes.runStart = kIsRun ? static_cast<int32_t>(kCandidates[kFirst]) : -1;
+		return lanes;
+	}
+
+	COLLISION_TARGET_AVX2 __m256 LoadAvx2(const float* kValues, const SAvx2Lanes& kLanes) noexcept
+	{
+		if (kLanes.runStart >= 0)
+		{
+			return _mm256_maskload_ps(kValues + kLanes.runStart, kLanes.mask);
+		}
+		return _mm256_mask_i32gather_ps(_mm256_setzero_ps(), kValues, kLanes.indices, _mm256_castsi256_ps(kLanes.mask), 4);
+	}
+
+	// Turn a point into the own axes of 8 boxes. Multiplies and adds are kept separate rather than fused, so the
+	// rounding matches GetBoxLocalX and GetBoxLocalZ.
+	COLLISION_TARGET_AVX2 __m256 GetBoxLocalXAvx2(const __m256& kAxisX, const __m256& kAxisZ, const __m256& kX, const __m256& kZ) noexcept
+	{
+		return _mm256_add_ps(_mm256_mul_ps(kX, kAxisX), _mm256_mul_ps(kZ, kAxisZ));
+	}
+	COLLISION_TARGET_AVX2 __m256 GetBoxLocalZAvx2(const __m256& kAxisX, const __m256& kAxisZ, const __m256& kX, const __m256& kZ) noexcept
+	{
+		return _mm256_sub_ps(_mm256_mul_ps(kZ, kAxisX), _mm256_mul_ps(kX, kAxisZ));
+	}
+
+	COLLISION_TARGET_AVX2 SBoxHits TestSphereBoxesAvx2(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kPreviousX, const float& kPreviousZ, const float& kRadius)
+	{
+		const bool kIsRun = IsRun(kCandidates, kCount);
+		const __m256 kSphereX = _mm256_set1_ps(kX);
+		const __m256 kSphereZ = _mm256_set1_ps(kZ);
+		const __m256 kSpherePreviousX = _mm256_set1_ps(kPreviousX);
+		const __m256 kSpherePreviousZ = _mm256_set1_ps(kPreviousZ);
+		const __m256 kSphereRadius = _mm256_set1_ps(kRadius);
+		SBoxHits result{ 0, 0 };
+		for (size_t first = 0; first < kCount; first += 8)
+		{
+			const SAvx2Lanes kLanes = GetLanesAvx2(kCandidates, first, kCount, kIsRun);
+			const __m256 kAxisX = LoadAvx2(kColliders.GetAxisX(), kLanes);
+			const __m256 kAxisZ = LoadAvx2(kColliders.GetAxisZ(), kLanes);
+			const __m256 kLocalX = GetBoxLocalXAvx2(kAxisX, kAxisZ, kSphereX, kSphereZ);
+			const __m256 kLocalZ = GetBoxLocalZAvx2(kAxisX, kAxisZ, kSphereX, kSphereZ);
+			const __m256 kPreviousLocalX = GetBoxLocalXAvx2(kAxisX, kAxisZ, kSpherePreviousX, kSpherePreviousZ);
+			const __m256 kBoxX = LoadAvx2(kColliders.GetLocalX(), kLanes);
+			const __m256 kBoxZ = LoadAvx2(kColliders.GetLocalZ(), kLanes);
+			const __m256 kHalfWidth = LoadAvx2(kColliders.GetHalfWidth(), kLanes);
+			const __m256 kHalfLength = LoadAvx2(kColliders.GetHalfLength(), kLanes);
+			const __m256 kMaxX = _mm256_add_ps(_mm256_add_ps(kBoxX, kHalfWidth), kSphereRadius);
+			const __m256 kMinX = _mm256_sub_ps(_mm256_sub_ps(kBoxX, kHalfWidth), kSphereRadius);
+			const __m256 kMaxZ = _mm256_add_ps(_mm256_add_ps(kBoxZ, kHalfLength), kSphereRadius);
+			const __m256 kMinZ = _mm256_sub_ps(_mm256_sub_ps(kBoxZ, kHalfLength), kSphereRadius);
+			const __m256 kHit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(kLocalX, kMaxX, _CMP_LT_OQ), _mm256_cmp_ps(kLocalX, kMinX, _CMP_GT_OQ)), _mm256_and_ps(_mm256_cmp_ps(kLocalZ, kMaxZ, _CMP_LT_OQ), _mm256_cmp_ps(kLocalZ, kMinZ, _CMP_GT_OQ)));
+			const __m256 kXAxis = _mm256_or_ps(_mm256_cmp_ps(kPreviousLocalX, kMinX, _CMP_LT_OQ), _mm256_cmp_ps(kPreviousLocalX, kMaxX, _CMP_GT_OQ));
+			result.hits |= static_cast<uint32_t>(_mm256_movemask_ps(kHit)) << first;
+			result.xAxis |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(kHit, kXAxis))) << first;
+		}
+		result.hits &= GetBatchMask(kCount);
+		result.xAxis &= GetBatchMask(kCount);
+		return result;
+	}
+
+	COLLISION_TARGET_AVX2 uint32_t TestPointBoxesAvx2(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ)
+	{
+		const bool kIsRun = IsRun(kCandidates, kCount);
+		const __m256 kPointX = _mm256_set1_ps(kX);
+		const __m256 kPointZ = _mm256_set1_ps(kZ);
+		uint32_t hits = 0;
+		for (size_t first = 0; first < kCount; first += 8)
+		{
+			const SAvx2Lanes kLanes = GetLanesAvx2(kCandidates, first, kCount, kIsRun);
+			const __m256 kAxisX = LoadAvx2(kColliders.GetAxisX(), kLanes);
+			const __m256 kAxisZ = LoadAvx2(kColliders.GetAxisZ(), kLanes);
+			const __m256 kLocalX = GetBoxLocalXAvx2(kAxisX, kAxisZ, kPointX, kPointZ);
+			const __m256 kLocalZ = GetBoxLocalZAvx2(kAxisX, kAxisZ, kPointX, kPointZ);
+			const __m256 kBoxX = LoadAvx2(kColliders.GetLocalX(), kLanes);
+			const __m256 kBoxZ = LoadAvx2(kColliders.GetLocalZ(), kLanes);
+			const __m256 kHalfWidth = LoadAvx2(kColliders.GetHalfWidth(), kLanes);
+			const __m256 kHalfLength = LoadAvx2(kColliders.GetHalfLength(), kLanes);
+			const __m256 kInsideX = _mm256_and_ps(_mm256_cmp_ps(kLocalX, _mm256_sub_ps(kBoxX, kHalfWidth), _CMP_GT_OQ), _mm256_cmp_ps(kLocalX, _mm256_add_ps(kBoxX, kHalfWidth), _CMP_LT_OQ));
+			const __m256 kInsideZ = _mm256_and_ps(_mm256_cmp_ps(kLocalZ, _mm256_sub_ps(kBoxZ, kHalfLength), _CMP_GT_OQ), _mm256_cmp_ps(kLocalZ, _mm256_add_ps(kBoxZ, kHalfLength), _CMP_LT_OQ));
+			hits |= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(kInsideX, kInsideZ))) << first;
+		}
+		return hits & GetBatchMask(kCount);
+	}
+
+	// A car is rarely near more than one water tank, and loading a single sphere into vector registers costs more than
+	// testing it, so the sphere test stays scalar until a vector version beats it in Tools/CollisionBenchmark.
+	constexpr SKernelSet kSse2Kernels{ TestSphereBoxesSse2, TestSphereSpheresScalar, TestPointBoxesSse2 };
+	constexpr SKernelSet kAvx2Kernels{ TestSphereBoxesAvx2, TestSphereSpheresScalar, TestPointBoxesAvx2 };
+
+	bool HasSse2() noexcept
+	{
+#ifdef _MSC_VER
+		int registers[4];
+		__cpuid(registers, 1);
+		return (registers[3] & (1 << 26)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse2");
+#endif
+	}
+
+	bool HasAvx2() noexcept
+	{
+#ifdef _MSC_VER
+		int registers[4];
+		__cpuid(registers, 0);
+		if (registers[0] < 7)
+		{
+			return false;
+		}
+		// The operating system has to save the AVX registers when switching threads, or they can't be used
+		__cpuid(registers, 1);
+		const bool kHasOsSave = (registers[2] & (1 << 27)) != 0;
+		const bool kHasAvx = (registers[2] & (1 << 28)) != 0;
+		if (!kHasOsSave || !kHasAvx || (_xgetbv(0) & 6) != 6)
+		{
+			return false;
+		}
+		__cpuidex(registers, 7, 0);
+		return (registers[1] & (1 << 5)) != 0;
+#else
+		// Also checks the operating system saves the AVX registers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	// The best kernels this CPU can run
+	ECollisionKernel GetBestCollisionKernel() noexcept
+	{
+		if (IsCollisionKernelSupported(ECollisionKernel::avx2))
+		{
+			return ECollisionKernel::avx2;
+		}
+		if (IsCollisionKernelSupported(ECollisionKernel::sse2))
+		{
+			return ECollisionKernel::sse2;
+		}
+		return ECollisionKernel::scalar;
+	}
+
+	// The kernels in use. Chosen the first time a kernel is used.
+	ECollisionKernel& GetKernelInUse() noexcept
+	{
+		static ECollisionKernel kernel = GetBestCollisionKernel();
+		return kernel;
+	}
+
+	const SKernelSet& GetKernelSet() noexcept
+	{
+		switch (GetKernelInUse())
+		{
+#ifdef COLLISION_KERNELS_X86
+		case ECollisionKernel::avx2:
+			return kAvx2Kernels;
+		case ECollisionKernel::sse2:
+			return kSse2Kernels;
+#endif
+		default:
+			return kScalarKernels;
+		}
+	}
+}
+
+SBoxHits TestSphereBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kPreviousX, const float& kPreviousZ, const float& kRadius) noexcept
+{
+	return GetKernelSet().sphereBoxes(kColliders, kCandidates, kCount, kX, kZ, kPreviousX, kPreviousZ, kRadius);
+}
+
+uint32_t TestSphereSpheres(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept
+{
+	return GetKernelSet().sphereSpheres(kColliders, kCandidates, kCount, kX, kZ, kRadius);
+}
+
+uint32_t TestPointBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ) noexcept
+{
+	return GetKernelSet().pointBoxes(kColliders, kCandidates, kCount, kX, kZ);
+}
+
+bool IsCollisionKernelSupported(const ECollisionKernel& kKernel) noexcept
+{
+	switch (kKernel)
+	{
+	case ECollisionKernel::scalar:
+		return true;
+#ifdef COLLISION_KERNELS_X86
+	case ECollisionKernel::sse2:
+	{
+		static const bool kSupported = HasSse2();
+		return kSupported;
+	}
+	case ECollisionKernel::avx2:
+	{
+		static const bool kSupported = HasAvx2();
+		return kSupported;
+	}
+#endif
+	default:
+		return false;
+	}
+}
+
+ECollisionKernel GetCollisionKernel() noexcept
+{
+	return GetKernelInUse();
+}
+
+bool SetCollisionKernel(const ECollisionKernel& kKernel) noexcept
+{
+	if (!IsCollisionKernelSupported(kKernel))
+	{
+		return false;
+	}
+	GetKernelInUse() = kKernel;
+	return true;
+}
+
+const char* GetCollisionKernelName(const ECollisionKernel& kKernel) noexcept
+{
+	switch (kKernel)
+	{
+	case ECollisionKernel::scalar:
+		return "scalar";
+	case ECollisionKernel::sse2:
+		return "SSE2";
+	case ECollisionKernel::avx2:
+		return "AVX2";
+	default:
+		return "Unknown";
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for hit masks
+#include "StaticColliders.h" // CStaticColliders
+
+// Batch narrow phase kernels
+// Test one car against a batch of up to kKernelBatchSize static colliders at once, and return a mask with a bit per
+// collider. There are AVX2 (8 colliders per instruction), SSE2 (4 per instruction) and scalar versions of the box
+// kernels; the sphere kernel is scalar in every set, as its vector versions were slower on real levels.
+// The best set the CPU supports is picked the first time a kernel is used. The scalar version is the shared collision
+// tests in Shared/Collision.h, and every version gives the same result as them, to the last bit. Box tests are done in each box's
+// own axes, so turned boxes are tested the same way as axis-aligned ones.
+// Candidates must be in ascending order with no repeats, as the broadphases return them.
+
+// The most colliders one kernel call tests
+constexpr size_t kKernelBatchSize = 16;
+
+enum class ECollisionKernel
+{
+	scalar,
+	sse2,
+	avx2,
+
+	collisionKernelsTotal
+};
+
+// The result of testing a sphere against a batch of boxes
+struct SBoxHits
+{
+	uint32_t hits; // Bit i is set if the sphere is inside box i
+	uint32_t xAxis; // Bit i is set if hit i collides parallel to box i's own x axis, clear if parallel to its z axis
+};
+
+// Test a sphere against a batch of box colliders. kCount must be at most kKernelBatchSize.
+// The previous position of the sphere decides the axis of each hit, the same way as IsSphereBoxCollided.
+SBoxHits TestSphereBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kPreviousX, const float& kPreviousZ, const float& kRadius) noexcept;
+// Test a sphere against a batch of sphere colliders. kCount must be at most kKernelBatchSize.
+// Returns a mask with bit i set if the sphere overlaps sphere i.
+uint32_t TestSphereSpheres(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept;
+// Test a point against a batch of box colliders. kCount must be at most kKernelBatchSize.
+// Returns a mask with bit i set if the point is inside box i.
+uint32_t TestPointBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ) noexcept;
+
+// Check if this CPU, and the operating system, can run a set of kernels.
+bool IsCollisionKernelSupported(const ECollisionKernel& kKernel) noexcept;
+// Get the set of kernels in use.
+ECollisionKernel GetCollisionKernel() noexcept;
+// Use a set of kernels, eg. to compare them. Returns false, and changes nothing, if the CPU can't run them.
+bool SetCollisionKernel(const ECollisionKernel& kKernel) noexcept;
+const char* GetCollisionKernelName(const ECollisionKernel& kKernel) noexcept;
+
+// Get the index of the lowest set bit of a mask that is not 0
+inline size_t GetFirstHit(const uint32_t& kMask) noexcept
+{
+	size_t index = 0;
+	while ((kMask & (1u << index)) == 0)
+	{
+		index++;
+	}
+	return index;
+}
@@ -0,0 +1,63 @@
+#include "ContactManifold.h"
+#include <algorithm> // max
+#include <cmath> // sqrtf
+
+void CContactManifold::Add(const SContact& kContact) noexcept
+{
+	if (count_ < kCapacity)
+	{
+		contacts_[count_++] = kContact;
+		return;
+	}
+	size_t shallowest = 0;
+	for (size_t i = 1; i < count_; i++)
+	{
+		if (contacts_[i].depth < contacts_[shallowest].depth)
+		{
+			shallowest = i;
+		}
+	}
+	if (kContact.depth > contacts_[shallowest].depth)
+	{
+		contacts_[shallowest] = kContact;
+	}
+}
+
+SContactResponse CContactManifold::Resolve(const float& kMomentumX, const float& kMomentumZ, const float& kSkin, const float& kBounce) const noexcept
+{
+	SContactResponse response{ 0.0f, 0.0f, kMomentumX, kMomentumZ };
+	for (size_t i = 0; i < count_; i++)
+	{
+		const SContact& kContact = contacts_[i];
+		// Only push as far as the contacts before this one haven't already, so two walls facing the same way, or the
+		// same wall found twice, push the car out once.
+		const float kPushed = response.pushX * kContact.normalX + response.pushZ * kContact.normalZ;
+		const float kClear = (kContact.depth > 0.0f) ? kContact.depth + kSkin : 0.0f;
+		if (kClear > kPushed)
+		{
+			response.pushX += (kClear - kPushed) * kContact.normalX;
+			response.pushZ += (kClear - kPushed) * kContact.normalZ;
+		}
+		// Likewise the momentum only bounces off a surface it is still moving into
+		const float kInto = response.momentumX * kContact.normalX + response.momentumZ * kContact.normalZ;
+		if (kInto < 0.0f)
+		{
+			response.momentumX -= (1.0f + kBounce) * kInto * kContact.normalX;
+			response.momentumZ -= (1.0f + kBounce) * kInto * kContact.normalZ;
+		}
+	}
+	return response;
+}
+
+SContact GetCircleContact(const float& kX, const float& kZ, const float& kRadius, const float& kOtherX, const float& kOtherZ, const float& kOtherRadius) noexcept
+{
+	const float kDistanceX = kX - kOtherX;
+	const float kDistanceZ = kZ - kOtherZ;
+	const float kDistance = sqrtf(kDistanceX * kDistanceX + kDistanceZ * kDistanceZ);
+	const float kDepth = std::max(0.0f, kRadius + kOtherRadius - kDistance);
+	if (kDistance == 0.0f)
+	{
+		return { 1.0f, 0.0f, kDepth };
+	}
+	return { kDistanceX / kDistance, kDistanceZ / kDistance, kDepth };
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <array> // Fixed size contact list
+#include <cstddef> // size_t
+
+// Contacts found for one car in one frame, resolved together
+// The narrow phase adds a contact for everything the car touches, instead of moving the car and changing its momentum
+// straight away. Once every test is done, the contacts are resolved in one pass: the car is pushed out of all of them
+// with a single move, and its momentum bounces once off each surface it is moving into. A car wedged between a wall and
+// a water tank is moved once and damaged once, rather than rolled back and slowed down by each of them in turn.
+
+// Where a car touches something
+struct SContact
+{
+	float normalX; // The direction that pushes the car out, as a unit vector
+	float normalZ;
+	float depth; // How far the car has to move along the normal to stop touching. 0 if it is only just touching.
+};
+
+// How a car is moved and bounced to resolve its contacts
+struct SContactResponse
+{
+	float pushX;
+	float pushZ;
+	float momentumX;
+	float momentumZ;
+};
+
+class CContactManifold
+{
+public:
+	// The most contacts kept. A car rarely touches more than a few things at once.
+	static constexpr size_t kCapacity = 8;
+
+private:
+	std::array<SContact, kCapacity> contacts_{};
+	size_t count_ = 0;
+
+public:
+	// Add a contact. When the manifold is full, the new contact replaces the shallowest one if it is deeper.
+	void Add(const SContact& kContact) noexcept;
+	void Clear() noexcept
+	{
+		count_ = 0;
+	}
+	bool IsEmpty() const noexcept
+	{
+		return count_ == 0;
+	}
+	size_t GetCount() const noexcept
+	{
+		return count_;
+	}
+	const SContact& GetContact(const size_t& kIndex) const noexcept
+	{
+		return contacts_[kIndex];
+	}
+
+	// Work out the move that pushes the car out of every contact, and its momentum after bouncing off them.
+	// A car inside something is pushed kSkin further than its depth, so it is left clear rather than on the surface.
+	// kBounce is how much of the momentum into a surface is kept, reversed. Momentum away from a surface is kept as it is.
+	SContactResponse Resolve(const float& kMomentumX, const float& kMomentumZ, const float& kSkin, const float& kBounce) const noexcept;
+};
+
+// Get the contact between a circle and another circle, pushing the first one away from the second.
+// Circles at the same position are pushed apart along the x axis.
+SContact GetCircleContact(const float& kX, const float& kZ, const float& kRadius, const float& kOtherX, const float& kOtherZ, const float& kOtherRadius) noexcept;
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef> // size_t
+#include <string_view> // Level text and file names
+#include "LevelCompileTime.h" // Compile-time level parser
+
+// Levels shipped with the game, embedded in the executable and parsed by the compiler.
+// Each .inc file holds a level from the media folder as a raw string literal, and is regenerated from it by the
+// pre-build step (see README.md). A malformed shipped level fails the build.
+// The embedded copy only stands in for the file it was made from: the loader still reads the file if it has been
+// edited since the build.
+
+struct SEmbeddedLevel
+{
+	std::string_view levelFile; // Path of the level file the objects came from, as the game loads it
+	std::string_view text; // Text of the level file at build time
+	const SLevelObject* objects;
+	size_t objectCount;
+};
+
+constexpr std::string_view kLevel1Text =
+#include "level1.glf.inc"
+;
+constexpr auto kLevel1Objects = ParseEmbeddedLevel<CountLevelObjects(kLevel1Text)>(kLevel1Text);
+
+constexpr SEmbeddedLevel kEmbeddedLevels[]
+{
+	{ "./media/level1.glf", kLevel1Text, kLevel1Objects.data(), kLevel1Objects.size() }
+};
+
+// Find the embedded copy of a level file. Returns nullptr if the level is not embedded.
+// Only the path the level shipped at matches, so a level of the same name in another folder is read from its file.
+inline const SEmbeddedLevel* FindEmbeddedLevel(const std::string_view& kLevelFile) noexcept
+{
+	for (const SEmbeddedLevel& kLevel : kEmbeddedLevels)
+	{
+		if (kLevel.levelFile == kLevelFile)
+		{
+			return &kLevel;
+		}
+	}
+	return nullptr;
+}
@@ -0,0 +1,40 @@
+#include "FixedTimestep.h"
+#include <cmath> // fabs, fmod
+
+namespace
+{
+	// How far a frame time can be from a whole number of ticks and still be counted as exactly that many, in seconds.
+	// Small next to a tick, so a frame rate that really is different from the tick rate is not snapped.
+	constexpr double kSnapTolerance = 0.0002;
+}
+
+CFixedTimestep::CFixedTimestep(const float& kTickTime, const int& kMaxTicksPerFrame) noexcept
+	: tickTime_(kTickTime), maxTicksPerFrame_(kMaxTicksPerFrame)
+{
+}
+
+int CFixedTimestep::Advance(const float& kFrameTime) noexcept
+{
+	double frameTime = kFrameTime;
+	for (int ticks = 1; ticks <= maxTicksPerFrame_; ticks++)
+	{
+		if (std::fabs(frameTime - ticks * static_cast<double>(tickTime_)) < kSnapTolerance)
+		{
+			frameTime = ticks * static_cast<double>(tickTime_);
+			break;
+		}
+	}
+	accumulator_ += frameTime;
+	int ticks = 0;
+	while (accumulator_ >= tickTime_ && ticks < maxTicksPerFrame_)
+	{
+		accumulator_ -= tickTime_;
+		ticks++;
+	}
+	// Too far behind to catch up. Keep the part of a tick, so the interpolation carries on smoothly.
+	if (accumulator_ >= tickTime_)
+	{
+		accumulator_ = std::fmod(accumulator_, static_cast<double>(tickTime_));
+	}
+	return ticks;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// A fixed timestep for the simulation
+// The race is simulated in ticks that are all the same length, whatever the frame rate, so it plays the same at 30
+// frames per second as at 300 and one slow frame can't move anything further than a tick at a time. The time each frame
+// takes is added to an accumulator, and a tick is run for each whole tick it holds. What is left over is less than a
+// tick, and is used to show the models part of the way between the last two ticks.
+// A frame that takes within kSnapTolerance of a whole number of ticks is counted as exactly that long. The time a
+// frame is measured to take wobbles a little either side of the refresh rate, and at 60 frames per second that would
+// otherwise run no tick one frame and two the next.
+class CFixedTimestep
+{
+private:
+	float tickTime_; // How long each tick is, in seconds
+	int maxTicksPerFrame_; // The most ticks run for one frame
+	double accumulator_ = 0.0; // Time not yet simulated. A double, so adding up short frames does not lose time.
+
+public:
+	CFixedTimestep(const float& kTickTime, const int& kMaxTicksPerFrame) noexcept;
+
+	// Add the time a frame took, and return how many ticks to run for it.
+	// After a very slow frame only kMaxTicksPerFrame ticks are run and the rest of the time is dropped, so the game
+	// slows down for a moment instead of taking longer and longer to catch up.
+	int Advance(const float& kFrameTime) noexcept;
+	// Drop the time not yet simulated, eg. when the race starts again.
+	void Reset() noexcept
+	{
+		accumulator_ = 0.0;
+	}
+	// How far the time left over is into the next tick, from 0 to 1
+	float GetInterpolation() const noexcept
+	{
+		return static_cast<float>(accumulator_ / tickTime_);
+	}
+	float GetTickTime() const noexcept
+	{
+		return tickTime_;
+	}
+};
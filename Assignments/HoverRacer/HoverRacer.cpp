@@ -4,7 +4,7 @@
 #include <string> // String class
 //#include <thread> // Used for multi-threading
 #include <cmath> // Maths library for c++
-//#include <chrono> // Timing, thread sleeping
+#include <chrono> // Timing level reloads
 #include <iostream> // Console output
 //#include <cstdio> // File input and output
 #include <fstream> // File input and output
@@ -12,6 +12,22 @@
 //#include <algorithm>
 #include <limits> // maximum data type values
 #include <TL-Engine.h>	// TL-Engine include file and namespace
+#include "../../Shared/Collision.h" // The collision tests shared with the other games
+#include "CollisionBroadphase.h" // Colliders listed by a grid or a bounding volume hierarchy
+#include "CollisionCasts.h" // Finding what lies between two points
+#include "CollisionKernels.h" // Testing a batch of colliders at once
+#include "ContactManifold.h" // Resolving everything a car touches at once
+#include "FixedTimestep.h" // Simulating the race in ticks of the same length
+#include "Level.h" // Level object records shared by the level loaders
+#include "LevelLoader.h" // Levels read on a worker thread
+#include "LevelSectors.h" // Level objects grouped by grid square, for streaming
+#include "LevelWatcher.h" // Reloading levels when they are edited
+#include "MeshRegistry.h" // Meshes loaded once, when first needed
+#include "StaticColliders.h" // Colliders stored apart from the models, as arrays of floats
+#include "SweepAndPrune.h" // Finding the hover cars that touch each other
+#include <deque> // Sectors waiting for models
+#include <unordered_set> // Loaded sectors
+#include <utility> // pair
 
 // Ignore warnings about enum class, invalid pointers, marking as not_null, gsl::at()
 #pragma warning(disable : 26812 26486 26429 26446)
@@ -23,12 +39,31 @@ float HalfOf(const float& kF) noexcept;
 // Return a random number in the range between rangeMin and rangeMax inclusive
 // range_min <= random number <= range_max
 float GetRandomFloat(const int& kRangeMin, const int& kRangeMax) noexcept;
+// Move, rotate and scale a model to match an object from a level file
+void PlaceLevelModel(IModel* model, const SLevelObject& kLevelObject);
+// List colliders in a collision broadphase by the area each one covers
+template <typename Collider>
+void BuildBroadphase(const vector<Collider>& kColliders, CCollisionBroadphase& broadphase);
+void BuildBroadphase(const CStaticColliders& kColliders, CCollisionBroadphase& broadphase);
 
 // Constant declaration
-constexpr unsigned int kGridSize = 50; // How big each grid square is. x * x dimensions.
-// Check this many squares in the x and z axis relative to the current grid.
-// EG when kGridVicinity = 1, check the current grid, and +-1 on x and +-1 on z (9 in total)
-constexpr int kGridVicinity = 1;
+// Size of the collision grid cells. Smaller than kGridSize, so a query near the player returns fewer colliders.
+constexpr float kCollisionCellSize = 20.0f;
+// How far short of a box a swept car is stopped, and how far clear of anything it is pushed out of, so it is left
+// outside rather than on the surface
+constexpr float kCollisionSkin = 0.01f;
+// How many boxes a car can run into and slide along in one step. Anything left after that is not moved.
+constexpr int kMaxCollisionSweeps = 4;
+// A car that hits something keeps this much of its momentum towards it, reversed
+constexpr float kContactBounce = 0.5f;
+// The race is simulated in ticks this long, whatever the frame rate
+constexpr float kSimulationTick = 1.0f / 60.0f;
+// The most ticks run for one frame. Any more time than that is dropped, and the race slows down for a moment.
+constexpr int kMaxTicksPerFrame = 5;
+// The chase camera is kept at least this far from the scenery between it and the player
+constexpr float kCameraRadius = 2.0f;
+// How quickly the chase camera moves back out once the scenery is out of the way, as a share of its offset per second
+constexpr float kCameraArmSpeed = 2.0f;
 constexpr int kArrayOffset = 1; // 0th item = 1st index for humans.
 constexpr float kGameCountdownTimer = 3.0f; // Count down for 3 seconds before the game starts.
 constexpr float kGameGoTimer = 1.0f; // Show "Go!" for x seconds when the race is starting
@@ -36,14 +71,19 @@ constexpr float kGameStageTimer = 1.0f; // How long to show "Stage X complete!"
 constexpr float kScale = 1.0f / 6.0f;
 constexpr float kSpeedConversion = 3.6f; // 1 Metre/s = 3.6 Kilomteres /h
 constexpr float kCollisionDelay = 0.2f; // Health can only decrease every x seconds.
-const string kCheckpointObject = "Checkpoint";
-const string kIsleStraightObject = "Isle";
-const string kWallObject = "Wall";
-const string kWaypointObject = "Waypoint";
-const string kWaterTankObject = "WaterTank";
 constexpr float kGravity = -2.35f;
 constexpr float kMinHeight = 0.0f;
 constexpr unsigned int kLaps = 2;
+// Scenery is created for the grid squares up to this many squares away from the player, and recycled once it is further than kSectorUnloadRadius.
+// The gap between the two stops sectors on a boundary from being created and recycled every frame.
+constexpr int kSectorLoadRadius = 4;
+constexpr int kSectorUnloadRadius = kSectorLoadRadius + 1;
+constexpr float kHiddenY = -1000.0f; // Recycled models wait out of sight, below the ground.
+constexpr size_t kModelsPerFrame = 64; // Most level models to create in one frame, so loading never stalls the game.
+// The mesh file for each level object type, indexed by ELevelObjectType
+const string kLevelMeshFiles[ELevelObjectType::objectTypesTotal]{ "Checkpoint.x", "IsleStraight.x", "Wall.x", "TankSmall1.x", "Dummy.x" };
+constexpr float kPlayerStartPos[]{ -100.0f, 0.0f, -73.0f };
+constexpr float kEnemyStartPos[]{ -100.0f, 0.0f, -87.0f };
 
 // Control Scheme
 const EKeyCode EGamePause = EKeyCode::Key_P;
@@ -68,6 +108,7 @@ const EKeyCode EGameResetKey = EKeyCode::Key_R;
 // The possible states for the game to be in.
 enum EGameStates
 {
+	loading,
 	starting,
 	playing,
 	paused,
@@ -77,24 +118,6 @@ enum EGameStates
 	gameStatesTotal
 };
 
-// What items is the level file made from
-enum EGameFileIndexes
-{
-	objectIndex,
-	xPosIndex,
-	yPosIndex,
-	zPosIndex,
-	globalXRotationIndex,
-	globalYRotationIndex,
-	globalZRotationIndex,
-	localXRotationIndex,
-	localYRotationIndex,
-	localZRotationIndex,
-	scaleIndex,
-
-	fileIndexesTotal
-};
-
 // Components of a 2D Vector
 enum EVector2D
 {
@@ -144,16 +167,6 @@ enum EReturnCodes
 	CodeEngineInitFail = 702
 };
 
-// When dealing with grids on the map
-enum EGridVicinity
-{
-	sameGrid,
-	closeBy, // currently not in use
-	notInVicinity,
-
-	gridVicinityTotal
-};
-
 // Structs
 
 // Store the x and y coordinates of a Heads Up Display element. Used when drawing items on screen.
@@ -172,6 +185,8 @@ struct SVector2D
 
 // Multiply a 2D vector by a scalar
 SVector2D ScalarMulti(const float& kS, const SVector2D& kV) noexcept;
+// Scale the part of a 2D vector along one of a box's own axes, eg. to bounce off or slide along the side of a box
+SVector2D ScaleAlongBoxAxis(const SVector2D& kV, const float& kAxisX, const float& kAxisZ, const bool& kIsXAxis, const float& kScale) noexcept;
 
 // Classes
 
@@ -182,6 +197,11 @@ private: // Set to known bad values.
 	string type_ = "";
 	int gridX_ = numeric_limits<int>::min();
 	int gridZ_ = numeric_limits<int>::min();
+	// The edges of the grid square the object is in. Empty until the square is known, so the first UpdateGrid finds it.
+	float gridMinX_ = numeric_limits<float>::max();
+	float gridMaxX_ = -numeric_limits<float>::max();
+	float gridMinZ_ = numeric_limits<float>::max();
+	float gridMaxZ_ = -numeric_limits<float>::max();
 	float radius_ = -numeric_limits<float>::max();
 	float width_ = -numeric_limits<float>::max();
 	float length_ = -numeric_limits<float>::max();
@@ -207,31 +227,33 @@ public:
 	{
 		type_ = kType;
 	}
-	// Automatically set the grid X and grid Z based on model position.
-	void UpdateGrid()
-	{
-		// do the X coordinate for the grid
-		const float kModelX = model_->GetX();
-		// Always get the positive number.
-		float tempX = fabsf(kModelX);
-		tempX /= kGridSize;
-		int tempIntX = static_cast<int>(round(tempX));
-		// if model pos is -ve, set to -ve
-		if (kModelX < 0.0f)
-		{
-			tempIntX = -tempIntX;
-		}
-		gridX_ = tempIntX;	
-
-		const float kModelZ = model_->GetZ();
-		float tempZ = fabsf(kModelZ);
-		tempZ /= kGridSize;
-		int tempIntZ = static_cast<int>(round(tempZ));
-		if (kModelZ < 0.0f)
+	// Keep the grid X and grid Z up to date with the model position.
+	// Returns true only if the object crossed into a different grid square since the last call.
+	bool UpdateGrid()
+	{
+		const float kX = model_->GetX();
+		const float kZ = model_->GetZ();
+		// Strictly inside the current square, so still in it. On an edge, rounding decides which square it is in.
+		if (kX > gridMinX_ && kX < gridMaxX_ && kZ > gridMinZ_ && kZ < gridMaxZ_)
 		{
-			tempIntZ = -tempIntZ;
+			return false;
 		}
-		gridZ_ = tempIntZ;
+		const int kGridX = GetGridIndex(kX);
+		const int kGridZ = GetGridIndex(kZ);
+		const bool kChanged = (kGridX != gridX_ || kGridZ != gridZ_);
+		SetGrid(kGridX, kGridZ);
+		return kChanged;
+	}
+	// Set the grid X and grid Z of an object, eg. one that does not move, from its level.
+	void SetGrid(const int& kGridX, const int& kGridZ) noexcept
+	{
+		gridX_ = kGridX;
+		gridZ_ = kGridZ;
+		constexpr float kHalfSquare = kGridSize / 2.0f;
+		gridMinX_ = kGridX * static_cast<float>(kGridSize) - kHalfSquare;
+		gridMaxX_ = kGridX * static_cast<float>(kGridSize) + kHalfSquare;
+		gridMinZ_ = kGridZ * static_cast<float>(kGridSize) - kHalfSquare;
+		gridMaxZ_ = kGridZ * static_cast<float>(kGridSize) + kHalfSquare;
 	}
 	// Get the x component of the grid
 	int GetGridX() const noexcept
@@ -272,10 +294,9 @@ public:
 class CCheckpoint : public CGameObject
 {
 private:
-	vector<CGameObject> struts_;
+	SCheckpointStruts struts_{}; // Where the struts at either end stand
+	SBoxAxis axis_{ 1.0f, 0.0f }; // The gate's own x axis
 	unsigned int stage_ = numeric_limits<unsigned int>::max();
-	float strutRadius_ = 1.0f;
-	float strutDiameter_ = 2.0f * strutRadius_;	
 	const float kLifetimeMax_ = 1.0f;
 	float currentLifetime_ = -1.0f;
 
@@ -288,17 +309,21 @@ public:
 	{
 		stage_ = kStage;
 	}
-	float GetStrutRadius() const noexcept
+	const SCheckpointStruts& GetStruts() const noexcept
+	{
+		return struts_;
+	}
+	void SetStruts(const SCheckpointStruts& kStruts) noexcept
 	{
-		return strutRadius_;
+		struts_ = kStruts;
 	}
-	const vector<CGameObject> GetStrutVector() const
+	const SBoxAxis& GetAxis() const noexcept
 	{
-		return struts_;
+		return axis_;
 	}
-	void SetStrutVector(const vector<CGameObject> kStrutVector)
+	void SetAxis(const SBoxAxis& kAxis) noexcept
 	{
-		struts_ = kStrutVector;
+		axis_ = kAxis;
 	}
 	void UpdateCross(IModel* cross, const float& kFrametime, const float& kGameSpeed)
 	{
@@ -319,6 +344,244 @@ public:
 	{
 		currentLifetime_ = kLifetimeMax_;
 	}
+	// Take the cross off this checkpoint straight away, eg. before the checkpoint is removed.
+	void HideCross(IModel* cross)
+	{
+		if (currentLifetime_ > 0.0f)
+		{
+			cross->DetachFromParent();
+			cross->MoveLocalY(-1000.0f);
+			currentLifetime_ = -1.0f;
+		}
+	}
+};
+
+class CSceneryStreamer // Creates the scenery of the level around the player, and recycles scenery the player has left behind.
+{
+private:
+	// A sector waiting for its models, and how many of its objects already have one
+	struct SPendingSector
+	{
+		int gridX;
+		int gridZ;
+		size_t created;
+	};
+
+	CLevelSectors sectors_; // Every scenery object in the level
+	CMeshRegistry* meshes_ = nullptr; // Loads the mesh of each object type when the first one is created
+	vector<IModel*> freeModels_[ELevelObjectType::objectTypesTotal]; // Hidden models from recycled sectors, ready for reuse
+	unordered_set<uint64_t> loadedSectors_; // Sectors in range of the player, including the ones still being created
+	deque<SPendingSector> pendingSectors_; // Sectors in range that still need models, closest first
+	size_t pendingModels_ = 0; // Models still needed by the pending sectors
+	vector<CGameObject> boxObjects_; // Box scenery in the loaded sectors
+	vector<CGameObject> sphereObjects_; // Sphere scenery in the loaded sectors
+	int centreGridX_ = numeric_limits<int>::min();
+	int centreGridZ_ = numeric_limits<int>::min();
+	size_t modelCount_ = 0; // Every model created so far, loaded or hidden
+
+	// Reuse a hidden model of the right type, or create one if there are none left
+	IModel* GetFreeModel(const ELevelObjectType& kType)
+	{
+		if (freeModels_[kType].empty())
+		{
+			modelCount_++;
+			return meshes_->Get(kLevelMeshFiles[kType])->CreateModel();
+		}
+		IModel* model = freeModels_[kType].back();
+		freeModels_[kType].pop_back();
+		return model;
+	}
+	void CreateSceneryObject(const SLevelObject& kLevelObject, const int& kGridX, const int& kGridZ)
+	{
+		IModel* model = GetFreeModel(kLevelObject.type);
+		PlaceLevelModel(model, kLevelObject);
+
+		CGameObject object;
+		object.SetModel(model);
+		object.SetLength(kLevelObject.length);
+		object.SetWidth(kLevelObject.width);
+		object.SetRadius(kLevelObject.radius);
+		object.SetType(string(GetLevelObjectName(kLevelObject.type)));
+		object.SetGrid(kGridX, kGridZ);
+		if (kLevelObject.type == ELevelObjectType::objectWaterTank)
+		{
+			sphereObjects_.push_back(object);
+		}
+		else
+		{
+			boxObjects_.push_back(object);
+		}
+	}
+	// Hide the models of every object in a recycled sector and give them back to the free lists.
+	void UnloadObjects(vector<CGameObject>& objects)
+	{
+		size_t kept = 0;
+		for (CGameObject& object : objects)
+		{
+			if (loadedSectors_.count(GetSectorKey(object.GetGridX(), object.GetGridZ())) != 0)
+			{
+				objects[kept++] = object;
+				continue;
+			}
+			ELevelObjectType type = ELevelObjectType::objectTypesTotal;
+			GetLevelObjectType(object.GetType(), type);
+			object.GetModel()->SetY(kHiddenY);
+			freeModels_[type].push_back(object.GetModel());
+		}
+		objects.resize(kept);
+	}
+	// Forget the pending sectors that went out of range before their models were created.
+	void DropPendingSectors()
+	{
+		deque<SPendingSector> kept;
+		for (const SPendingSector& kSector : pendingSectors_)
+		{
+			if (loadedSectors_.count(GetSectorKey(kSector.gridX, kSector.gridZ)) != 0)
+			{
+				kept.push_back(kSector);
+			}
+			else
+			{
+				size_t count = 0;
+				sectors_.GetSector(kSector.gridX, kSector.gridZ, count);
+				pendingModels_ -= count - kSector.created;
+			}
+		}
+		pendingSectors_.swap(kept);
+	}
+
+public:
+	void SetMeshRegistry(CMeshRegistry* meshes) noexcept
+	{
+		meshes_ = meshes;
+	}
+	// Replace the scenery with a level's. The old scenery is hidden for reuse. Call Update to choose the sectors around the player.
+	void SetLevel(CLevelSectors&& sectors)
+	{
+		sectors_ = move(sectors);
+		loadedSectors_.clear();
+		pendingSectors_.clear();
+		pendingModels_ = 0;
+		UnloadObjects(boxObjects_);
+		UnloadObjects(sphereObjects_);
+		centreGridX_ = numeric_limits<int>::min();
+		centreGridZ_ = numeric_limits<int>::min();
+	}
+	// Swap in an edited copy of the level. Only the sectors that changed are recreated, the next time Update is called.
+	// Returns how many sectors changed.
+	size_t ReplaceLevel(CLevelSectors&& sectors)
+	{
+		const vector<uint64_t> kChangedSectors = sectors_.GetChangedSectors(sectors);
+		sectors_ = move(sectors);
+		size_t unloaded = 0;
+		for (const uint64_t kSector : kChangedSectors)
+		{
+			unloaded += loadedSectors_.erase(kSector);
+		}
+		if (unloaded > 0)
+		{
+			UnloadObjects(boxObjects_);
+			UnloadObjects(sphereObjects_);
+			DropPendingSectors();
+		}
+		// Make the next Update queue the sectors again
+		centreGridX_ = numeric_limits<int>::min();
+		centreGridZ_ = numeric_limits<int>::min();
+		return kChangedSectors.size();
+	}
+	// Queue the sectors around an object for loading, and recycle the ones that are too far away. Does nothing until the object changes grid square.
+	// The models are created by CreatePendingModels.
+	void Update(const CGameObject& kCentre)
+	{
+		if (kCentre.GetGridX() == centreGridX_ && kCentre.GetGridZ() == centreGridZ_)
+		{
+			return;
+		}
+		centreGridX_ = kCentre.GetGridX();
+		centreGridZ_ = kCentre.GetGridZ();
+
+		// Recycle first, so the sectors being loaded can reuse the models.
+		const size_t kLoadedBefore = loadedSectors_.size();
+		for (auto sector = loadedSectors_.begin(); sector != loadedSectors_.end();)
+		{
+			const int kGridX = GetSectorGridX(*sector);
+			const int kGridZ = GetSectorGridZ(*sector);
+			if (abs(kGridX - centreGridX_) > kSectorUnloadRadius || abs(kGridZ - centreGridZ_) > kSectorUnloadRadius)
+			{
+				sector = loadedSectors_.erase(sector);
+			}
+			else
+			{
+				sector++;
+			}
+		}
+		if (loadedSectors_.size() != kLoadedBefore)
+		{
+			UnloadObjects(boxObjects_);
+			UnloadObjects(sphereObjects_);
+			DropPendingSectors();
+		}
+
+		// Queue ring by ring, so the sectors closest to the player get their models first.
+		for (int ring = 0; ring <= kSectorLoadRadius; ring++)
+		{
+			for (int gridX = centreGridX_ - ring; gridX <= centreGridX_ + ring; gridX++)
+			{
+				for (int gridZ = centreGridZ_ - ring; gridZ <= centreGridZ_ + ring; gridZ++)
+				{
+					if (abs(gridX - centreGridX_) != ring && abs(gridZ - centreGridZ_) != ring)
+					{
+						continue; // Inside an earlier ring
+					}
+					size_t count = 0;
+					sectors_.GetSector(gridX, gridZ, count);
+					if (count != 0 && loadedSectors_.insert(GetSectorKey(gridX, gridZ)).second)
+					{
+						pendingSectors_.push_back({ gridX, gridZ, 0 });
+						pendingModels_ += count;
+					}
+				}
+			}
+		}
+	}
+	// Create up to kMaxModels of the models the queued sectors still need.
+	void CreatePendingModels(const size_t& kMaxModels)
+	{
+		size_t created = 0;
+		while (!pendingSectors_.empty() && created < kMaxModels)
+		{
+			SPendingSector& sector = pendingSectors_.front();
+			size_t count = 0;
+			const SLevelObject* kLevelObjects = sectors_.GetSector(sector.gridX, sector.gridZ, count);
+			for (; sector.created < count && created < kMaxModels; sector.created++, created++)
+			{
+				CreateSceneryObject(kLevelObjects[sector.created], sector.gridX, sector.gridZ);
+			}
+			if (sector.created == count)
+			{
+				pendingSectors_.pop_front();
+			}
+		}
+		pendingModels_ -= created;
+	}
+	// How many models the queued sectors still need
+	size_t GetPendingModelCount() const noexcept
+	{
+		return pendingModels_;
+	}
+	const vector<CGameObject>& GetBoxObjects() const noexcept
+	{
+		return boxObjects_;
+	}
+	const vector<CGameObject>& GetSphereObjects() const noexcept
+	{
+		return sphereObjects_;
+	}
+	// How many scenery models exist, including hidden ones waiting to be reused
+	size_t GetModelCount() const noexcept
+	{
+		return modelCount_;
+	}
 };
 
 class CHoverCar : public CGameObject // Standard class used by all hover cars
@@ -329,6 +592,8 @@ protected:
 	SVector2D drag_{ 0.0f, 0.0f }; // Current drag vector
 	SVector2D facing_{ 0.0f, 0.0f }; // Current facing vector
 	float modelMatrix_[EModelMatrix::matrixTotal][EModelMatrix::matrixTotal]{ 0.0f };
+	float tickStartMatrix_[EModelMatrix::matrixTotal][EModelMatrix::matrixTotal]{ 0.0f }; // The model's matrix at the start of the last simulation tick
+	float tickEndMatrix_[EModelMatrix::matrixTotal][EModelMatrix::matrixTotal]{ 0.0f }; // The model's matrix at the end of it, while an earlier one is shown
 	float previousX_ = 0.0f; // The x position of the hover car in the previous frame
 	float previousZ_ = 0.0f; // The z position of the hover car in the previous frame
 	float thrustMultiplier_ = 60.0f; // Thrust multiplier. Increasing this increases the maximum speed and acceleration of the hover car.
@@ -414,6 +679,31 @@ public:
 	{
 		return begin(*modelMatrix_);
 	}
+	// Keep where the model is at the start of a simulation tick
+	void StartTick() noexcept
+	{
+		GetModel()->GetMatrix(begin(*tickStartMatrix_));
+	}
+	// Show the model part of the way from the start of the last tick to its end, from 0 to 1. Over one tick the car
+	// turns very little, so the axes are interpolated along with the position.
+	void ShowBetweenTicks(const float& kInterpolation) noexcept
+	{
+		GetModel()->GetMatrix(begin(*tickEndMatrix_));
+		float shown[EModelMatrix::matrixTotal][EModelMatrix::matrixTotal];
+		for (int row = 0; row < EModelMatrix::matrixTotal; row++)
+		{
+			for (int column = 0; column < EModelMatrix::matrixTotal; column++)
+			{
+				shown[row][column] = tickStartMatrix_[row][column] + (tickEndMatrix_[row][column] - tickStartMatrix_[row][column]) * kInterpolation;
+			}
+		}
+		GetModel()->SetMatrix(begin(*shown));
+	}
+	// Put the model back where the last tick left it, after it has been shown between ticks
+	void EndShowingBetweenTicks() noexcept
+	{
+		GetModel()->SetMatrix(begin(*tickEndMatrix_));
+	}
 	float GetPreviousX() const noexcept
 	{
 		return previousX_;
@@ -451,6 +741,11 @@ public:
 	{
 		return moveSpeed_;
 	}
+	// How far around the car to look for colliders: its radius, plus how far it moves in a frame at its current speed.
+	float GetCollisionReach(const float& kFrametime, const float& kGameSpeed) const noexcept
+	{
+		return GetRadius() + moveSpeed_ * kFrametime * kGameSpeed;
+	}
 	void PerformCollision() noexcept
 	{
 		if (lastCollision_ <= 0.0f)
@@ -580,374 +875,243 @@ float GetDotProduct(const SVector2D& v1, const SVector2D& v2) noexcept
 	return ((v1.x * v2.x) + (v1.z * v2.z));
 }
 
-// Used when parsing the level file
-void PrintErrorMessage(const unsigned int& kLineIndex, const unsigned int& kItemIndex, const string& kLevelFile, const exception* kException)
+void PlaceLevelModel(IModel* model, const SLevelObject& kLevelObject)
+{
+	model->SetPosition(kLevelObject.position[EVector3D::x3D], kLevelObject.position[EVector3D::y3D], kLevelObject.position[EVector3D::z3D]);
+	model->ResetOrientation();
+	model->ResetScale();
+	model->RotateX(kLevelObject.globalRotation[EVector3D::x3D]);
+	model->RotateY(kLevelObject.globalRotation[EVector3D::y3D]);
+	model->RotateZ(kLevelObject.globalRotation[EVector3D::z3D]);
+	model->RotateLocalX(kLevelObject.localRotation[EVector3D::x3D]);
+	model->RotateLocalY(kLevelObject.localRotation[EVector3D::y3D]);
+	model->RotateLocalZ(kLevelObject.localRotation[EVector3D::z3D]);
+	model->Scale(kLevelObject.scale);
+}
+
+// Move a checkpoint or waypoint to match an object from a level file
+void PlaceRaceObject(const SRaceObject& kRaceObject, CGameObject& object)
+{
+	const SLevelObject& kLevelObject = kRaceObject.object;
+	PlaceLevelModel(object.GetModel(), kLevelObject);
+	object.SetLength(kLevelObject.length);
+	object.SetWidth(kLevelObject.width);
+	object.SetRadius(kLevelObject.radius);
+	object.SetType(string(GetLevelObjectName(kLevelObject.type)));
+	object.SetGrid(kRaceObject.gridX, kRaceObject.gridZ);
+}
+
+// Create the model and game object for a checkpoint or waypoint. Scenery is created by the streamer instead.
+void CreateRaceObject(CMeshRegistry& meshes, const SRaceObject& kRaceObject, vector<CCheckpoint>& checkpoints, vector<CGameObject>& waypoints)
 {
-	if (kException != nullptr)
+	CCheckpoint object;
+	object.SetModel(meshes.Get(kLevelMeshFiles[kRaceObject.object.type])->CreateModel());
+	PlaceRaceObject(kRaceObject, object);
+
+	if (kRaceObject.object.type == ELevelObjectType::objectCheckpoint)
 	{
-		cout << "ERROR: " << kException->what() << ". Line " << kLineIndex + kArrayOffset << ", Index " << kItemIndex + kArrayOffset << "\n";
-		cout << "Check the " << kLevelFile << " file. Aborting..." << endl;
+		object.SetStruts(kRaceObject.struts);
+		object.SetAxis(kRaceObject.axis);
+		object.SetStage(checkpoints.size());
+		checkpoints.push_back(object); // Create a copy of the item rather than emplacing
 	}
 	else
 	{
-		cout << "ERROR: Something went wrong. Line " << kLineIndex + kArrayOffset << ", Index " << kItemIndex + kArrayOffset << "\n";
-		cout << "Check the " << kLevelFile << " file. Aborting..." << endl;
+		waypoints.push_back(object);
 	}
-	char ch;
-	cin >> ch;
 }
 
-// Load objects from a game level file
-void LoadLevelFromFile(I3DEngine* myEngine, const string& kLevelFile, vector<CCheckpoint>& checkpoints, vector<CGameObject>& sphereObjects, vector<CGameObject>& boxObjects, vector<CGameObject>& waypoints)
+void RemoveCheckpoint(CMeshRegistry& meshes, IModel* cross, CCheckpoint& checkpoint)
+{
+	checkpoint.HideCross(cross);
+	meshes.Get(kLevelMeshFiles[ELevelObjectType::objectCheckpoint])->RemoveModel(checkpoint.GetModel());
+}
+
+// Remove the checkpoints and waypoints of the current level, before the next level is created.
+void RemoveRaceObjects(CMeshRegistry& meshes, IModel* cross, vector<CCheckpoint>& checkpoints, vector<CGameObject>& waypoints)
 {
-	//	// Input file stream
-	ifstream inputStream(kLevelFile);
-	if (!inputStream)
+	for (CCheckpoint& checkpoint : checkpoints)
 	{
-		cout << "Error:  File cannot be accessed/does not exist.\nFile: " << kLevelFile << endl;
-		char ch;
-		cin >> ch;
-		exit(CodeSaveFileFail);
+		RemoveCheckpoint(meshes, cross, checkpoint);
 	}
+	for (const CGameObject& kWaypoint : waypoints)
+	{
+		meshes.Get(kLevelMeshFiles[ELevelObjectType::objectWaypoint])->RemoveModel(kWaypoint.GetModel());
+	}
+	checkpoints.clear();
+	waypoints.clear();
+}
 
-	// Load all the meshes to create the objects later
-
-	const string kCheckpointFile = "Checkpoint.x";
-	IMesh* checkpointMesh = myEngine->LoadMesh(kCheckpointFile);
-	constexpr float kCheckpointWidth = 19.0f;
-	constexpr float kCheckpointLength = 2.0f;
-	constexpr float kStrutRadius = 1.2f; // 1.25f
-	// The checkpoint width includes the struct diameter * 2; struct radius * 4;
-	constexpr float kCheckpointWidthNoStruts = kCheckpointWidth - (4.0f * kStrutRadius);
+// Bring the checkpoints and waypoints in line with an edited level.
+// Checkpoints and waypoints are matched up by their order in the level, as that is what the race uses them by.
+// Only the ones that changed are moved, and any extra ones are created or removed. Returns how many changed.
+size_t UpdateRaceObjects(CMeshRegistry& meshes, IModel* cross, const vector<SRaceObject>& kOldObjects, const vector<SRaceObject>& kNewObjects, vector<CCheckpoint>& checkpoints, vector<CGameObject>& waypoints)
+{
+	// Split both lists by type, keeping their order
+	vector<const SRaceObject*> oldCheckpoints, newCheckpoints, oldWaypoints, newWaypoints;
+	for (const SRaceObject& kObject : kOldObjects)
+	{
+		(kObject.object.type == ELevelObjectType::objectCheckpoint ? oldCheckpoints : oldWaypoints).push_back(&kObject);
+	}
+	for (const SRaceObject& kObject : kNewObjects)
+	{
+		(kObject.object.type == ELevelObjectType::objectCheckpoint ? newCheckpoints : newWaypoints).push_back(&kObject);
+	}
 
-	const string kIsleStraightFile = "IsleStraight.x";
-	IMesh* isleStraightMesh = myEngine->LoadMesh(kIsleStraightFile);
-	constexpr float kIsleStraightLength = 7.0f;
-	constexpr float kIsleStraightWidth = 4.5f; // 5.0f
+	size_t changed = 0;
+	for (size_t i = 0; i < min(oldCheckpoints.size(), newCheckpoints.size()); i++)
+	{
+		if (!IsSameLevelObject(oldCheckpoints[i]->object, newCheckpoints[i]->object))
+		{
+			checkpoints[i].HideCross(cross);
+			PlaceRaceObject(*newCheckpoints[i], checkpoints[i]);
+			checkpoints[i].SetStruts(newCheckpoints[i]->struts);
+			checkpoints[i].SetAxis(newCheckpoints[i]->axis);
+			changed++;
+		}
+	}
+	while (checkpoints.size() > newCheckpoints.size())
+	{
+		RemoveCheckpoint(meshes, cross, checkpoints.back());
+		checkpoints.pop_back();
+		changed++;
+	}
 
-	const string kWallFile = "Wall.x";
-	IMesh* wallMesh = myEngine->LoadMesh(kWallFile);
-	constexpr float kWallLength = 10.0f;
-	constexpr float kWallWidth = 4.5f; // 1.5f
+	for (size_t i = 0; i < min(oldWaypoints.size(), newWaypoints.size()); i++)
+	{
+		if (!IsSameLevelObject(oldWaypoints[i]->object, newWaypoints[i]->object))
+		{
+			PlaceRaceObject(*newWaypoints[i], waypoints[i]);
+			changed++;
+		}
+	}
+	while (waypoints.size() > newWaypoints.size())
+	{
+		meshes.Get(kLevelMeshFiles[ELevelObjectType::objectWaypoint])->RemoveModel(waypoints.back().GetModel());
+		waypoints.pop_back();
+		changed++;
+	}
 
-	const string kWaterTankFile = "TankSmall1.x";
-	IMesh* waterTankMesh = myEngine->LoadMesh(kWaterTankFile);
-	constexpr float kTankRadius = 4.5f;
+	for (size_t i = checkpoints.size(); i < newCheckpoints.size(); i++, changed++)
+	{
+		CreateRaceObject(meshes, *newCheckpoints[i], checkpoints, waypoints);
+	}
+	for (size_t i = waypoints.size(); i < newWaypoints.size(); i++, changed++)
+	{
+		CreateRaceObject(meshes, *newWaypoints[i], checkpoints, waypoints);
+	}
+	return changed;
+}
 
-	const string kDummyFile = "Dummy.x";
-	IMesh* dummyMesh = myEngine->LoadMesh(kDummyFile);
-	vector<CGameObject> struts;
+// The area a sphere object, such as a hover car, covers
+SGridBounds GetColliderBounds(const CGameObject& kObject)
+{
+	const float kX = kObject.GetModel()->GetX();
+	const float kZ = kObject.GetModel()->GetZ();
+	return { kX - kObject.GetRadius(), kX + kObject.GetRadius(), kZ - kObject.GetRadius(), kZ + kObject.GetRadius() };
+}
 
-	const string kWaypointFile = "Dummy.x";
-	IMesh* waypointMesh = dummyMesh;
+// The area a checkpoint covers, including its struts
+SGridBounds GetColliderBounds(const CCheckpoint& kCheckpoint)
+{
+	const float kX = kCheckpoint.GetModel()->GetX();
+	const float kZ = kCheckpoint.GetModel()->GetZ();
+	// A turned gate covers its half sizes along both of its axes
+	const float kAxisX = fabsf(kCheckpoint.GetAxis().x);
+	const float kAxisZ = fabsf(kCheckpoint.GetAxis().z);
+	const float kHalfWidth = kAxisX * HalfOf(kCheckpoint.GetWidth()) + kAxisZ * HalfOf(kCheckpoint.GetLength());
+	const float kHalfLength = kAxisZ * HalfOf(kCheckpoint.GetWidth()) + kAxisX * HalfOf(kCheckpoint.GetLength());
+	SGridBounds bounds{ kX - kHalfWidth, kX + kHalfWidth, kZ - kHalfLength, kZ + kHalfLength };
+	for (const SStrut& kStrut : kCheckpoint.GetStruts())
+	{
+		bounds.minX = min(bounds.minX, kStrut.x - kStrutRadius);
+		bounds.maxX = max(bounds.maxX, kStrut.x + kStrutRadius);
+		bounds.minZ = min(bounds.minZ, kStrut.z - kStrutRadius);
+		bounds.maxZ = max(bounds.maxZ, kStrut.z + kStrutRadius);
+	}
+	return bounds;
+}
 
-	IMesh* currentMesh = nullptr;
-	
-	CCheckpoint object;
-	CGameObject strut;
+// List colliders in a collision broadphase by the area each one covers
+template <typename Collider>
+void BuildBroadphase(const vector<Collider>& kColliders, CCollisionBroadphase& broadphase)
+{
+	vector<SGridBounds> bounds;
+	bounds.reserve(kColliders.size());
+	for (const Collider& kCollider : kColliders)
+	{
+		bounds.push_back(GetColliderBounds(kCollider));
+	}
+	broadphase.Build(bounds);
+}
 
-	string currentItem;
-	float length = -numeric_limits<float>::max();
-	float width = -numeric_limits<float>::max();
-	float radius = -numeric_limits<float>::max();
-	int itemIndex = 0;
-	int lineIndex = 0;
-	constexpr unsigned int kItemsPerLine = EGameFileIndexes::fileIndexesTotal;
+// List static colliders in a collision broadphase by the area each one covers
+void BuildBroadphase(const CStaticColliders& kColliders, CCollisionBroadphase& broadphase)
+{
+	broadphase.Build(kColliders.GetBounds());
+}
 
-	// Iterate over the level file
-	while (!inputStream.eof())
-	{
-		inputStream >> currentItem;
-		switch (itemIndex)
-		{
-		case EGameFileIndexes::objectIndex:
+// Store the gates and struts of the checkpoints in the same order, so the race can test them without asking the models
+// where they are. Checkpoint i has struts 2 * i and 2 * i + 1.
+void AssignCheckpointGates(const vector<CCheckpoint>& kCheckpoints, CStaticColliders& gates, CStaticColliders& struts)
+{
+	gates.Clear();
+	gates.Reserve(kCheckpoints.size());
+	struts.Clear();
+	struts.Reserve(2 * kCheckpoints.size());
+	for (const CCheckpoint& kCheckpoint : kCheckpoints)
+	{
+		gates.AddBox(kCheckpoint.GetModel()->GetX(), kCheckpoint.GetModel()->GetZ(), HalfOf(kCheckpoint.GetWidth()), HalfOf(kCheckpoint.GetLength()), kCheckpoint.GetAxis(), ELevelObjectType::objectCheckpoint);
+		for (const SStrut& kStrut : kCheckpoint.GetStruts())
 		{
-			// Reset the measurements for the current object.
-			length = -numeric_limits<float>::max();
-			width = -numeric_limits<float>::max();
-			radius = -numeric_limits<float>::max(); 
+			struts.AddSphere(kStrut.x, kStrut.z, kStrutRadius, ELevelObjectType::objectCheckpoint);
+		}
+	}
+}
 
-			if (currentItem == kCheckpointObject)
-			{
-				// Set the current mesh depending on the object type.
-				currentMesh = checkpointMesh;
-				length = kCheckpointLength;
-				width = kCheckpointWidthNoStruts;
-			}
-			else if (currentItem == kWaterTankObject)
-			{
-				currentMesh = waterTankMesh;
-				radius = kTankRadius;
-			}
-			else if (currentItem == kIsleStraightObject)
-			{
-				currentMesh = isleStraightMesh;
-				width = kIsleStraightWidth;
-				length = kIsleStraightLength;
-			}
-			else if (currentItem == kWallObject)
-			{
-				currentMesh = wallMesh;
-				width = kWallWidth;
-				length = kWallLength;
-			}
-			else if (currentItem == kWaypointObject)
-			{
-				currentMesh = waypointMesh;
-			}
-			else // The object type is not recognised.
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, nullptr);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
+// How far the camera can go along the arm from a car to its offset from the car before the scenery gets in the way,
+// from 0 at the car to 1 at the offset. The offset is along the car's own axes, the same as a camera attached to it.
+float GetClearCameraArm(CSceneryCaster& caster, CHoverCar& car, const float kOffset[])
+{
+	car.GetModel()->GetMatrix(car.GetModelMatrix());
+	const float kCarX = car.GetModelMatrixComponent(EModelMatrix::position, EVector3D::x3D);
+	const float kCarZ = car.GetModelMatrixComponent(EModelMatrix::position, EVector3D::z3D);
+	const float kArmX = kOffset[EVector3D::x3D] * car.GetModelMatrixComponent(EModelMatrix::localX, EVector3D::x3D)
+		+ kOffset[EVector3D::y3D] * car.GetModelMatrixComponent(EModelMatrix::localY, EVector3D::x3D)
+		+ kOffset[EVector3D::z3D] * car.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::x3D);
+	const float kArmZ = kOffset[EVector3D::x3D] * car.GetModelMatrixComponent(EModelMatrix::localX, EVector3D::z3D)
+		+ kOffset[EVector3D::y3D] * car.GetModelMatrixComponent(EModelMatrix::localY, EVector3D::z3D)
+		+ kOffset[EVector3D::z3D] * car.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::z3D);
+	// The camera stops kCameraRadius short of whatever the arm passes through first
+	return caster.Cast({ kCarX, kCarZ, kCarX + kArmX, kCarZ + kArmZ, kCameraRadius }).time;
+}
 
-			object.SetModel(currentMesh->CreateModel());
-			object.SetLength(length);
-			object.SetWidth(width);
-			object.SetType(currentItem);
-			object.SetRadius(radius);
-
-			break;
-		}
-		case EGameFileIndexes::xPosIndex:
-		{
-			// Try get float from string
-			try
-			{
-				object.GetModel()->SetX(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::yPosIndex:
-		{
-			// Try get float from string
-			try
-			{
-				object.GetModel()->SetY(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::zPosIndex:
-		{
-			// Try get float from string
-			try
-			{
-				object.GetModel()->SetZ(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::globalXRotationIndex:
-		{
-			try
-			{
-				object.GetModel()->RotateX(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::globalYRotationIndex:
-		{
-			try
-			{
-				// Try get float from string
-				const float kRotation = static_cast<float>(stoi(currentItem));
-				constexpr int kRightAngle = 90;
-				constexpr int kCircle = 360;
-				// If the object is rotated by a right angle, rotate the bounding box with it
-				// Only support rigth angle rotation to make collision resolution easier.
-				if (static_cast<int>(kRotation) == kRightAngle || static_cast<int>(kRotation) == (kCircle - kRightAngle))
-				{
-					object.GetModel()->RotateY(static_cast<float>(stoi(currentItem)));
-					const float kLength = object.GetLength();
-					const float kWidth = object.GetWidth();
-					object.SetWidth(kLength);
-					object.SetLength(kWidth);
-				}
-				else if (static_cast<int>(kRotation) != 0 && static_cast<int>(kRotation) != kCircle)
-				{
-					PrintErrorMessage(lineIndex, itemIndex, kLevelFile, nullptr);
-					exit(EReturnCodes::CodeSaveFileFail);
-				}
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::globalZRotationIndex:
-		{
-			try
-			{
-				object.GetModel()->RotateZ(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::localXRotationIndex:
-		{
-			try
-			{
-				// Try get float from string
-				object.GetModel()->RotateLocalX(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::localYRotationIndex:
-		{
-			try
-			{
-				// Try get float from string
-				object.GetModel()->RotateLocalY(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::localZRotationIndex:
-		{
-			try
-			{
-				// Try get float from string
-				object.GetModel()->RotateLocalZ(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		case EGameFileIndexes::scaleIndex:
-		{
-			try
-			{
-				object.GetModel()->Scale(static_cast<float>(stoi(currentItem)));
-			}
-			catch (const exception* e)
-			{
-				PrintErrorMessage(lineIndex, itemIndex, kLevelFile, e);
-				exit(EReturnCodes::CodeSaveFileFail);
-			}
-			break;
-		}
-		default:
-		{
-			PrintErrorMessage(lineIndex, itemIndex, kLevelFile, nullptr);
-			exit(EReturnCodes::CodeSaveFileFail);
-		}
-		}
-		itemIndex++;
-		// If the end of the line is reached
-		if (itemIndex > kItemsPerLine - kArrayOffset)
-		{
-			lineIndex++;
-			itemIndex = 0;
-			// Push the object to scenery or checkpoint vector
-			object.UpdateGrid();
-			if (object.GetType() == kCheckpointObject)
-			{
-				// Create the struts.
-				// Clear local struts vector
-				// Push local struts into local struts vector
-				// Get the reference to object struts vector
-				// Assign the reference to local struts vector
-				// Check checkpoint rotation
-				struts.clear();
-				if (object.GetLength() > object.GetWidth())
-				{
-					strut.SetModel(dummyMesh->CreateModel(object.GetModel()->GetX(), object.GetModel()->GetY(), object.GetModel()->GetZ() + HalfOf(kCheckpointWidthNoStruts) + object.GetStrutRadius()));
-					struts.push_back(strut);
-					strut.SetModel(dummyMesh->CreateModel(object.GetModel()->GetX(), object.GetModel()->GetY(), object.GetModel()->GetZ() - HalfOf(kCheckpointWidthNoStruts) - object.GetStrutRadius()));
-					struts.push_back(strut);
-				}
-				else
-				{
-					strut.SetModel(dummyMesh->CreateModel(object.GetModel()->GetX() - HalfOf(kCheckpointWidthNoStruts) - object.GetStrutRadius(), object.GetModel()->GetY(), object.GetModel()->GetZ()));
-					struts.push_back(strut);
-					strut.SetModel(dummyMesh->CreateModel(object.GetModel()->GetX() + HalfOf(kCheckpointWidthNoStruts) + object.GetStrutRadius(), object.GetModel()->GetY(), object.GetModel()->GetZ()));
-					struts.push_back(strut);
-				}
-				object.SetStage(checkpoints.size());
-				object.SetStrutVector(struts);
-				checkpoints.push_back(object); // Create a copy of the item rather than emplacing			
-			}
-			else if (object.GetType() == kIsleStraightObject || object.GetType() == kWallObject)
-			{
-				boxObjects.push_back(object);
-			}
-			else if (object.GetType() == kWaterTankObject)
-			{
-				sphereObjects.push_back(object);
-			}
-			else if (object.GetType() == kWaypointObject)
-			{
-				waypoints.push_back(object);
-			}
-		}
-	}	
-	if (inputStream.eof())
-	{
-		cout << "Finished reading from file: " << kLevelFile << endl;
-	}
-}
-
-// Create the skybox object to give the impression of clouds
-void CreateSkybox(I3DEngine* myEngine, IModel* skybox)
-{
-	const float kSkyboxPos[]{ 0.0f, -960.0f, 0.0f };
-	const string kSkyboxFile = "Skybox 07.x";
-	IMesh* skyboxMesh = myEngine->LoadMesh(kSkyboxFile);
-	skybox = skyboxMesh->CreateModel(kSkyboxPos[EVector3D::x3D], kSkyboxPos[EVector3D::y3D], kSkyboxPos[EVector3D::z3D]); // The skybox model used to give impression of clouds.
-}
+// Create the skybox object to give the impression of clouds
+void CreateSkybox(CMeshRegistry& meshes, IModel* skybox)
+{
+	const float kSkyboxPos[]{ 0.0f, -960.0f, 0.0f };
+	const string kSkyboxFile = "Skybox 07.x";
+	IMesh* skyboxMesh = meshes.Get(kSkyboxFile);
+	skybox = skyboxMesh->CreateModel(kSkyboxPos[EVector3D::x3D], kSkyboxPos[EVector3D::y3D], kSkyboxPos[EVector3D::z3D]); // The skybox model used to give impression of clouds.
+}
 
 // Create the ground object for cars to hover over
-void CreateGround(I3DEngine* myEngine, IModel* ground)
+void CreateGround(CMeshRegistry& meshes, IModel* ground)
 {
 	const string kGroundFile = "ground.x";
-	IMesh* groundMesh = myEngine->LoadMesh(kGroundFile);
+	IMesh* groundMesh = meshes.Get(kGroundFile);
 	ground = groundMesh->CreateModel();
 }
 
 // Create the player object.
-void CreatePlayer(I3DEngine* myEngine, CPlayer& player)
+void CreatePlayer(CMeshRegistry& meshes, CPlayer& player)
 {
-	const float kPlayerInitialPos[]{ -100.0f, 0.0f, -73.0f };
 	const string kHoverCarFile = "race2.x";
-	IMesh* hoverCarMesh = myEngine->LoadMesh(kHoverCarFile);
-	player.SetModel(hoverCarMesh->CreateModel(kPlayerInitialPos[EVector3D::x3D], kPlayerInitialPos[EVector3D::y3D], kPlayerInitialPos[EVector3D::z3D]));
+	IMesh* hoverCarMesh = meshes.Get(kHoverCarFile);
+	player.SetModel(hoverCarMesh->CreateModel(kPlayerStartPos[EVector3D::x3D], kPlayerStartPos[EVector3D::y3D], kPlayerStartPos[EVector3D::z3D]));
+	// The first step is swept from the previous position, so it has to start where the player does
+	player.SetPreviousX(kPlayerStartPos[EVector3D::x3D]);
+	player.SetPreviousZ(kPlayerStartPos[EVector3D::z3D]);
 	constexpr float kLength = 12.0f; // 12.92f
 	player.SetLength(kLength);
 	constexpr float kWidth = 4.0f; // 4.46f
@@ -955,15 +1119,15 @@ void CreatePlayer(I3DEngine* myEngine, CPlayer& player)
 	constexpr float kRadius = 4.0f; // 5.0f
 	player.SetRadius(kRadius);
 	player.UpdateGrid();
+	player.StartTick();
 }
 
 // Create an enemy
-void CreateEnemy(I3DEngine* myEngine, CHoverCar& enemy)
+void CreateEnemy(CMeshRegistry& meshes, CHoverCar& enemy)
 {
-	const float kPosition[]{ -100.0f, 0.0f, -87.0f };
 	const string kEnemyFile = "race2.x";
-	IMesh* enemyMesh = myEngine->LoadMesh(kEnemyFile);
-	enemy.SetModel(enemyMesh->CreateModel(kPosition[EVector3D::x3D], kPosition[EVector3D::y3D], kPosition[EVector3D::z3D]));
+	IMesh* enemyMesh = meshes.Get(kEnemyFile);
+	enemy.SetModel(enemyMesh->CreateModel(kEnemyStartPos[EVector3D::x3D], kEnemyStartPos[EVector3D::y3D], kEnemyStartPos[EVector3D::z3D]));
 	const string kSkin = "sp01.jpg";
 	enemy.GetModel()->SetSkin(kSkin);
 	constexpr float kLength = 12.0f; // 12.92f
@@ -973,6 +1137,21 @@ void CreateEnemy(I3DEngine* myEngine, CHoverCar& enemy)
 	constexpr float kRadius = 4.0f; // 5.0f
 	enemy.SetRadius(kRadius);
 	enemy.UpdateGrid();
+	enemy.StartTick();
+}
+
+// Put a hover car back on the start line for a new race.
+void ResetHoverCar(CHoverCar& car, const float kPosition[EVector3D::vector3DTotal])
+{
+	car.GetModel()->SetPosition(kPosition[EVector3D::x3D], kPosition[EVector3D::y3D], kPosition[EVector3D::z3D]);
+	car.GetModel()->ResetOrientation();
+	car.SetMomentum({ 0.0f, 0.0f });
+	car.SetThrust({ 0.0f, 0.0f });
+	car.SetCurrentStage(0);
+	car.SetPreviousX(kPosition[EVector3D::x3D]);
+	car.SetPreviousZ(kPosition[EVector3D::z3D]);
+	car.UpdateGrid();
+	car.StartTick();
 }
 
 // Returns a half of a float
@@ -1002,61 +1181,36 @@ SVector2D ScalarMulti(const float& kS, const SVector2D& kV) noexcept
 	return{ kS * kV.x, kS * kV.z };
 }
 
-// Check if two objects are in the same grid or close by
-EGridVicinity AreGridsClose(const CGameObject& kObject1, const CGameObject& kObject2) noexcept
+SVector2D ScaleAlongBoxAxis(const SVector2D& kV, const float& kAxisX, const float& kAxisZ, const bool& kIsXAxis, const float& kScale) noexcept
 {
+	// Turn the vector into the box's axes, scale one part and turn it back. An axis of 1, 0 leaves it unturned.
+	float localX = GetBoxLocalX(kAxisX, kAxisZ, kV.x, kV.z);
+	float localZ = GetBoxLocalZ(kAxisX, kAxisZ, kV.x, kV.z);
+	(kIsXAxis ? localX : localZ) *= kScale;
+	return{ localX * kAxisX - localZ * kAxisZ, localX * kAxisZ + localZ * kAxisX };
+}
 
-	// Check if the grids are the same
-	if (kObject1.GetGridX() == kObject2.GetGridX() && kObject1.GetGridZ() == kObject2.GetGridZ())
-	{
-		return EGridVicinity::sameGrid;
-	}
-	// Only need to check diagonal corners eg. bottom left and top right
-	else if ((kObject2.GetGridZ() - kGridVicinity <= kObject1.GetGridZ() && kObject2.GetGridZ() + kGridVicinity >= kObject1.GetGridX()) 
-		&& (kObject2.GetGridZ() + kGridVicinity >= kObject1.GetGridZ() && kObject2.GetGridX() - kGridVicinity <= kObject1.GetGridX()))
-	{
-		return EGridVicinity::closeBy;
-	}
-	else
-	{
-		return EGridVicinity::notInVicinity;
-	}
+// Check sphere-sphere collision between a sphere model and a sphere
+bool IsSphereSphereCollided(const IModel* kSphere1, const float& kSphere1Radius, const float& kSphere2X, const float& kSphere2Z, const float& kSphere2Radius)
+{
+	// Don't need to check Y Coordinates
+	return IsCollided(SSphereShape{ kSphere1->GetX(), kSphere1->GetZ(), kSphere1Radius }, SSphereShape{ kSphere2X, kSphere2Z, kSphere2Radius });
 }
 
 // Check sphere-sphere collision between two objects
 bool IsSphereSphereCollided(const IModel* kSphere1, const float& kSphere1Radius, const IModel* kSphere2, const float& kSphere2Radius)
 {
-	// Don't need to check Y Coordinates
-	constexpr float kSquared = 2.0f; // Power of 2
-
-	const float kSphere1X = kSphere1->GetX();
-	const float kSphere1Z = kSphere1->GetZ();
-
-	const float kSphere2X = kSphere2->GetX();
-	const float kSphere2Z = kSphere2->GetZ();
-	
-	return (pow((kSphere2X - kSphere1X), kSquared) + pow((kSphere2Z - kSphere1Z), kSquared) < powf(kSphere1Radius + kSphere2Radius, kSquared));
+	return IsSphereSphereCollided(kSphere1, kSphere1Radius, kSphere2->GetX(), kSphere2->GetZ(), kSphere2Radius);
 }
 
-// Check if there is a collision between two models
-ECollisionAxis IsSphereBoxCollided(const IModel* kSphere, const float& kSpherePrevX, const float& kSpherePrevZ, const float& kSphereRadius, const IModel* kBox, const float& kBoxRadiusX, const float& kBoxRadiusZ)
+// Check if there is a collision between a sphere model and a box
+ECollisionAxis IsSphereBoxCollided(const IModel* kSphere, const float& kSpherePrevX, const float& kSpherePrevZ, const float& kSphereRadius, const float& kBoxX, const float& kBoxZ, const float& kBoxRadiusX, const float& kBoxRadiusZ)
 {
 	// Slightly inaccurate around corners.
-
-	const float kBoxX = kBox->GetX();
-	const float kBoxMaxX = kBoxX + kBoxRadiusX + kSphereRadius;
-	const float kBoxMinX = kBoxX - kBoxRadiusX - kSphereRadius;
-	const float kBoxZ = kBox->GetZ();
-	const float kBoxMaxZ = kBoxZ + kBoxRadiusZ + kSphereRadius;
-	const float kBoxMinZ = kBoxZ - kBoxRadiusZ - kSphereRadius;
-
-	const float kSphereX = kSphere->GetX();
-	const float kSphereZ = kSphere->GetZ();
-
-	if (kSphereX < kBoxMaxX && kSphereX > kBoxMinX && kSphereZ < kBoxMaxZ && kSphereZ > kBoxMinZ)
+	if (IsCollided(SSphereShape{ kSphere->GetX(), kSphere->GetZ(), kSphereRadius }, SBoxShape{ kBoxX, kBoxZ, kBoxRadiusX, kBoxRadiusZ }))
 	{
 		// Check collision axis
-		if (kSpherePrevX < kBoxMinX || kSpherePrevX > kBoxMaxX)
+		if (kSpherePrevX < kBoxX - kBoxRadiusX - kSphereRadius || kSpherePrevX > kBoxX + kBoxRadiusX + kSphereRadius)
 		{
 			// Colliding parallel to the x axis
 			return ECollisionAxis::xAxis;
@@ -1073,23 +1227,25 @@ ECollisionAxis IsSphereBoxCollided(const IModel* kSphere, const float& kSpherePr
 	}
 }
 
-// Check point to box collision between two models
-bool IsPointBoxCollided(const IModel* kPoint, const IModel* kBox, const float& kBoxRadiusX, const float& kBoxRadiusZ)
+// Check if there is a collision between two models
+ECollisionAxis IsSphereBoxCollided(const IModel* kSphere, const float& kSpherePrevX, const float& kSpherePrevZ, const float& kSphereRadius, const IModel* kBox, const float& kBoxRadiusX, const float& kBoxRadiusZ)
 {
-	const float kPointX = kPoint->GetX();
-	const float kPointZ = kPoint->GetZ();
+	return IsSphereBoxCollided(kSphere, kSpherePrevX, kSpherePrevZ, kSphereRadius, kBox->GetX(), kBox->GetZ(), kBoxRadiusX, kBoxRadiusZ);
+}
 
-	const float kBoxX = kBox->GetX();
-	const float kBoxMaxX = kBoxX + kBoxRadiusX;
-	const float kBoxMinX = kBoxX - kBoxRadiusX;
-	const float kBoxZ = kBox->GetZ();
-	const float kBoxMaxZ = kBoxZ + kBoxRadiusZ;
-	const float kBoxMinZ = kBoxZ - kBoxRadiusZ;
+// Check point to box collision between a point and a box
+bool IsPointBoxCollided(const float& kPointX, const float& kPointZ, const float& kBoxX, const float& kBoxZ, const float& kBoxRadiusX, const float& kBoxRadiusZ) noexcept
+{
+	return IsCollided(SPointShape{ kPointX, kPointZ }, SBoxShape{ kBoxX, kBoxZ, kBoxRadiusX, kBoxRadiusZ });
+}
 
-	return (kPointZ > kBoxMinZ && kPointZ < kBoxMaxZ&& kPointX > kBoxMinX && kPointX < kBoxMaxX);
+// Check point to box collision between two models
+bool IsPointBoxCollided(const IModel* kPoint, const IModel* kBox, const float& kBoxRadiusX, const float& kBoxRadiusZ)
+{
+	return IsPointBoxCollided(kPoint->GetX(), kPoint->GetZ(), kBox->GetX(), kBox->GetZ(), kBoxRadiusX, kBoxRadiusZ);
 }
 
-int main()
+int main(int argc, char* argv[])
 {
 	// The engine type used.
 	const EEngineType kEngineType = EEngineType::kTLX;
@@ -1108,38 +1264,73 @@ int main()
 	myEngine->StartMouseCapture();
 	float gameSpeed = 1.0f; // The speed at which the game runs. Used for slow-motion effects.
 
+	// Every mesh is loaded through the registry, once, when the first model needs it.
+	CMeshRegistry meshes(myEngine);
 	// Add default folder for meshes and other media
 	const string kMedia = "./media";
-	myEngine->AddMediaFolder(kMedia);
+	meshes.AddMediaFolder(kMedia);
 
 	// Skybox used to give impression of clouds
 	IModel* skybox = nullptr;
-	CreateSkybox(myEngine, skybox);
+	CreateSkybox(meshes, skybox);
 
 	// The ground model the hover cars will hover above
 	IModel* ground = nullptr;
-	CreateGround(myEngine, ground);
+	CreateGround(meshes, ground);
 	
 	// List of all levels in the game
 	vector<string> levels { "./media/level1.glf" };
+	// Levels given on the command line replace the built in list, eg. ones made by the level generator.
+	if (argc > 1)
+	{
+		levels.assign(argv + 1, argv + argc);
+	}
 	unsigned int levelIndex = 0;
-	// All the scenery objects in the current level
-	vector<CGameObject> sceneryBoxObjects;
-	vector<CGameObject> scenerySphereObjects;
+	// The scenery objects in the current level, created around the player as they race
+	CSceneryStreamer scenery;
 	vector<CGameObject> waypoints;
 
 	// All the checkpoints in the current level
 	vector<CCheckpoint> checkpoints;
-	// Attempt to load the current level.
-	LoadLevelFromFile(myEngine, levels.at(levelIndex), checkpoints, scenerySphereObjects, sceneryBoxObjects, waypoints);
+	scenery.SetMeshRegistry(&meshes);
+	// Start reading the current level. The models are created in the loading state of the game loop.
+	CLevelLoader levelLoader;
+	levelLoader.Start(levels.at(levelIndex));
+	SLoadedLevel currentLevel; // The level whose models are being created, once the loader has finished it
+	bool isLevelRead = false; // Has the current level been taken from the loader
+	size_t raceObjectIndex = 0; // The next checkpoint or waypoint to create
+	size_t levelModelsTotal = 0; // Models to create before the level can be played
+	CLevelWatcher levelWatcher; // Watches the current level file, so edits show up without restarting
+	CStaticColliders boxColliders; // Collision boxes for the isles and walls of the current level
+	CCollisionBroadphase boxBroadphase(kCollisionCellSize); // boxColliders listed by the area they cover
+	CStaticColliders sphereColliders; // Collision spheres for the water tanks of the current level
+	CCollisionBroadphase sphereBroadphase(kCollisionCellSize); // sphereColliders listed by the area they cover
+	CStaticColliders checkpointGates; // The gate of each checkpoint, in the same order as checkpoints
+	CStaticColliders checkpointStruts; // The two struts of each checkpoint, in the same order as checkpoints
+	CCollisionBroadphase checkpointBroadphase(kCollisionCellSize); // checkpoints listed by the area they cover
+	// Finds what the scenery puts between two points, eg. between the player and the camera
+	CSceneryCaster sceneryCaster(boxColliders, boxBroadphase, sphereColliders, sphereBroadphase, checkpointStruts, checkpointBroadphase);
+	vector<uint32_t> collisionCandidates; // The colliders near the player, found in a collision broadphase
+	vector<uint32_t> strutCandidates; // The struts of the checkpoints near the player
 
 	CPlayer player; // The player-controlled hover car.
-	CreatePlayer(myEngine, player);
+	CreatePlayer(meshes, player);
 	CHoverCar enemy;
-	CreateEnemy(myEngine, enemy);
+	CreateEnemy(meshes, enemy);
+	const vector<CHoverCar*> kHoverCars{ &player, &enemy }; // Every hover car in the race. Body i of carSweep is kHoverCars[i].
+	CSweepAndPrune carSweep; // Finds the hover cars close enough to touch, without testing every pair
+	for (const CHoverCar* kCar : kHoverCars)
+	{
+		carSweep.Add(GetColliderBounds(*kCar));
+	}
+	vector<SBodyPair> carPairs; // The hover cars whose bounds overlap this frame
+	CContactManifold playerContacts; // Everything the player touches this frame, resolved together
 
 	// The position of the camera relative to the player
 	constexpr float kCameraPos[]{ 0.0f, 25.0f, -55.0f };
+	// Where the camera is placed relative to the player when nothing is in the way. Moved by the camera controls.
+	float cameraOffset[]{ kCameraPos[EVector3D::x3D], kCameraPos[EVector3D::y3D], kCameraPos[EVector3D::z3D] };
+	float cameraArm = 1.0f; // How far the camera is out towards cameraOffset, from 0 at the player to 1 at the offset
 	constexpr float kCameraSpeed = 50.0f; // The camera will move at this amount per second.
 	constexpr float kCameraRotationMax = 90.0f; // Max 90 degrees to left/right, and straight forward or straight down.
 	float cameraRotationY = 0.0f; // The current camera rotation on the y axis.
@@ -1153,7 +1344,7 @@ int main()
 	myCamera->SetLocalPosition(kCameraPos[EVector3D::x3D], kCameraPos[EVector3D::y3D], kCameraPos[EVector3D::z3D]);
 	
 	// The current state the game is in
-	EGameStates gameState = EGameStates::starting;
+	EGameStates gameState = EGameStates::loading;
 
 	// Set up HUD Elements
 	const SHUDInfo kHUDGameState = { 0, 0 }; // The position of where to draw the game state on screen
@@ -1179,6 +1370,7 @@ int main()
 	IFont* myFont = myEngine->LoadFont(kFontName); // Font used to draw HUD elements on screen.
 	const string kStartInstruction = "Hit Space to Start.";
 	const string kGoInstruction = "Go!";
+	const string kNextLevelInstruction = "Hit Space for the next level.";
 	bool drawCountdownText = false; // Draw the countdown before the game starts up?
 	bool drawGoText = false;
 	float countdownTimer = kGameCountdownTimer;
@@ -1203,8 +1395,9 @@ int main()
 
 	// Checkpoint cross
 	const string kCheckpointCross = "Cross.x";
-	IMesh* crossMesh = myEngine->LoadMesh(kCheckpointCross);
+	IMesh* crossMesh = meshes.Get(kCheckpointCross);
 	IModel* cross = crossMesh->CreateModel(0.0f, -1000.0f, 0.0f);
+	size_t crossCheckpoint = numeric_limits<size_t>::max(); // The checkpoint the cross was last shown on
 
 	// Prevent the mouse inputs from before the game loaded, to turn the camera
 	myEngine->GetMouseMovementX();
@@ -1212,18 +1405,96 @@ int main()
 
 	// How long it took to render the last frame.
 	float frametime = myEngine->Timer();
+	CFixedTimestep simulationClock(kSimulationTick, kMaxTicksPerFrame); // Turns the time each frame takes into simulation ticks
+	bool isShowingBetweenTicks = false; // Are the hover cars shown between ticks, rather than where the last tick left them
+
 
 	// The main game loop, repeat until engine is stopped
 	while (myEngine->IsRunning())
 	{
 		// Draw the scene
 		myEngine->DrawScene();
+		// The hover cars are shown between ticks from the end of the simulation ticks until the scene is drawn, and the
+		// next ticks start from where the last tick left them. In between, the camera arm is cast from where the player
+		// is shown, which is where the camera is drawn from, and a hot reload streams the scenery around it; both are
+		// less than a tick away from the last tick.
+		if (isShowingBetweenTicks)
+		{
+			for (CHoverCar* car : kHoverCars)
+			{
+				car->EndShowingBetweenTicks();
+			}
+			isShowingBetweenTicks = false;
+		}
 
 		// Update frametime
 		frametime = myEngine->Timer();
 
 		switch (gameState)
 		{
+		case EGameStates::loading:
+		{
+			// The loader reads the level on a worker thread. Once it is done, create the models a batch per frame.
+			if (!isLevelRead)
+			{
+				if (levelLoader.IsReady())
+				{
+					currentLevel = levelLoader.Take();
+					if (!currentLevel.succeeded)
+					{
+						cout << "ERROR: " << currentLevel.error.message << ". Line " << currentLevel.error.line << ", Column " << currentLevel.error.column << "\n";
+						cout << "Check the " << currentLevel.levelFile << " file. Aborting..." << endl;
+						exit(EReturnCodes::CodeSaveFileFail);
+					}
+					if (!currentLevel.warning.empty())
+					{
+						cout << "Warning: " << currentLevel.warning << endl;
+					}
+					cout << "Finished reading from file: " << currentLevel.source << endl;
+					cout << "Merged " << currentLevel.boxPieces << " isles and walls into " << currentLevel.boxColliders.size() << " box colliders." << endl;
+					boxColliders.AssignBoxes(currentLevel.boxColliders);
+					BuildBroadphase(boxColliders, boxBroadphase);
+					cout << "Box collision uses a " << ((boxBroadphase.GetType() == EBroadphaseType::bvh) ? "bounding volume hierarchy." : "uniform grid.") << endl;
+					cout << "Collision tests use the " << GetCollisionKernelName(GetCollisionKernel()) << " kernels." << endl;
+
+					sphereColliders.AssignSpheres(currentLevel.scenery.GetObjects(), currentLevel.scenery.GetObjects() + currentLevel.scenery.GetObjectCount());
+					BuildBroadphase(sphereColliders, sphereBroadphase);
+					scenery.SetLevel(move(currentLevel.scenery));
+					scenery.Update(player);
+					isLevelRead = true;
+					raceObjectIndex = 0;
+					levelModelsTotal = currentLevel.raceObjects.size() + scenery.GetPendingModelCount();
+				}
+			}
+			else
+			{
+				size_t created = 0;
+				for (; raceObjectIndex < currentLevel.raceObjects.size() && created < kModelsPerFrame; raceObjectIndex++, created++)
+				{
+					CreateRaceObject(meshes, currentLevel.raceObjects[raceObjectIndex], checkpoints, waypoints);
+				}
+				scenery.CreatePendingModels(kModelsPerFrame - created);
+				if (raceObjectIndex == currentLevel.raceObjects.size() && scenery.GetPendingModelCount() == 0)
+				{
+					AssignCheckpointGates(checkpoints, checkpointGates, checkpointStruts);
+					BuildBroadphase(checkpoints, checkpointBroadphase);
+					if (!levelWatcher.Watch(currentLevel.levelFile))
+					{
+						cout << "Warning: Could not watch " << currentLevel.levelFile << " for changes." << endl;
+					}
+					gameState = EGameStates::starting;
+				}
+			}
+
+			int progress = 0;
+			if (isLevelRead && levelModelsTotal > 0)
+			{
+				const size_t kModelsLeft = (currentLevel.raceObjects.size() - raceObjectIndex) + scenery.GetPendingModelCount();
+				progress = static_cast<int>(100 * (levelModelsTotal - kModelsLeft) / levelModelsTotal);
+			}
+			myFont->Draw("Loading level: " + to_string(progress) + "%", kHUDInstruction.x, kHUDInstruction.y);
+			break;
+		}
 		case EGameStates::starting:
 		{
 			myFont->Draw(kStartInstruction, kHUDInstruction.x, kHUDInstruction.y);
@@ -1237,167 +1508,229 @@ int main()
 		}
 		case EGameStates::playing:
 		{
-			if (drawCountdownText)
+			// The race is simulated in fixed ticks, as many as the time since the last frame holds
+			const int kTicks = simulationClock.Advance(frametime);
+			for (int tick = 0; tick < kTicks && gameState == EGameStates::playing; tick++)
 			{
-				myFont->Draw(to_string(static_cast<int>(ceilf(countdownTimer))), kHUDCountdown.x, kHUDCountdown.y);
-				countdownTimer -= (frametime * gameSpeed);
-				if (countdownTimer < 0.0f)
+				for (CHoverCar* car : kHoverCars)
 				{
-					drawCountdownText = false;
-					drawGoText = true;
+					car->StartTick();
 				}
-				break;
-			}
-			else if (drawGoText)
-			{
-				myFont->Draw(kGoInstruction, kHUDGo.x, kHUDGo.y);
-				goTimer -= (frametime * gameSpeed);
-				if (goTimer < 0.0f)
+
+				if (drawCountdownText)
 				{
-					drawGoText = false;
+					countdownTimer -= (kSimulationTick * gameSpeed);
+					if (countdownTimer < 0.0f)
+					{
+						drawCountdownText = false;
+						drawGoText = true;
+					}
+					continue;
 				}
-			}
-			else if (drawStageText)
-			{
-				if (player.GetCurrentStage() == 0)
+				else if (drawGoText)
 				{
-					myFont->Draw("Stage " + to_string(checkpoints.size() - 1) + " Complete!", kHUDStageComplete.x, kHUDStageComplete.y);
+					goTimer -= (kSimulationTick * gameSpeed);
+					if (goTimer < 0.0f)
+					{
+						drawGoText = false;
+					}
 				}
-				else
-				{
-					myFont->Draw("Stage " + to_string(player.GetCurrentStage() - 1) + " Complete!", kHUDStageComplete.x, kHUDStageComplete.y);
-				}				
-				stageTimer -= (frametime * gameSpeed);
-				if (stageTimer < 0.0f)
+				else if (drawStageText)
 				{
-					drawStageText = false;
+					stageTimer -= (kSimulationTick * gameSpeed);
+					if (stageTimer < 0.0f)
+					{
+						drawStageText = false;
+					}
 				}
-			}
 
-			// Get the facing vector of player
-			player.GetModel()->GetMatrix(player.GetModelMatrix());
-			player.SetFacingVector({ player.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::x3D), player.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::z3D) });
+				// Get the facing vector of player
+				player.GetModel()->GetMatrix(player.GetModelMatrix());
+				player.SetFacingVector({ player.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::x3D), player.GetModelMatrixComponent(EModelMatrix::localZ, EVector3D::z3D) });
 
-			// Rotation
-			if (myEngine->KeyHeld(EPlayerRotateRight))
-			{
-				player.GetModel()->RotateY(player.GetRotationSpeed() * frametime * gameSpeed);
-				if (playerSidewaysRotation > -kPlayerMaxSidewaysRotation)
+				// Rotation
+				if (myEngine->KeyHeld(EPlayerRotateRight))
 				{
-					player.GetModel()->RotateLocalZ(-frametime * gameSpeed * HalfOf(player.GetRotationSpeed()));
-					playerSidewaysRotation += -frametime * gameSpeed * HalfOf(player.GetRotationSpeed());
+					player.GetModel()->RotateY(player.GetRotationSpeed() * kSimulationTick * gameSpeed);
+					if (playerSidewaysRotation > -kPlayerMaxSidewaysRotation)
+					{
+						player.GetModel()->RotateLocalZ(-kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed()));
+						playerSidewaysRotation += -kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed());
+					}
+					playerRotated = true;
 				}
-				playerRotated = true;
-			}
-			else if (myEngine->KeyHeld(EPlayerRotateLeft))
-			{
-				player.GetModel()->RotateY(-player.GetRotationSpeed() * frametime * gameSpeed);
-				if (playerSidewaysRotation < kPlayerMaxSidewaysRotation)
+				else if (myEngine->KeyHeld(EPlayerRotateLeft))
 				{
-					player.GetModel()->RotateLocalZ(frametime * gameSpeed * HalfOf(player.GetRotationSpeed()));
-					playerSidewaysRotation += frametime * gameSpeed * HalfOf(player.GetRotationSpeed());
+					player.GetModel()->RotateY(-player.GetRotationSpeed() * kSimulationTick * gameSpeed);
+					if (playerSidewaysRotation < kPlayerMaxSidewaysRotation)
+					{
+						player.GetModel()->RotateLocalZ(kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed()));
+						playerSidewaysRotation += kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed());
+					}
+					playerRotated = true;
 				}
-				playerRotated = true;
-			}
 
-			// Calculate thrust based on input
-			if (myEngine->KeyHeld(EPlayerIncreaseForwardThrust))
-			{
-				player.SetThrust(ScalarMulti(player.GetThrustMultiplier() * frametime * gameSpeed * player.GetForwardThrustMulti(), player.GetFacingVector()));
-				if (playerAccelerationRotation > -kPlayerMaxAccelerationRotation)
+				// Calculate thrust based on input
+				if (myEngine->KeyHeld(EPlayerIncreaseForwardThrust))
 				{
-					player.GetModel()->RotateLocalX(-frametime * gameSpeed * HalfOf(player.GetRotationSpeed()));
-					playerAccelerationRotation += -frametime * gameSpeed * HalfOf(player.GetRotationSpeed());
+					player.SetThrust(ScalarMulti(player.GetThrustMultiplier() * kSimulationTick * gameSpeed * player.GetForwardThrustMulti(), player.GetFacingVector()));
+					if (playerAccelerationRotation > -kPlayerMaxAccelerationRotation)
+					{
+						player.GetModel()->RotateLocalX(-kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed()));
+						playerAccelerationRotation += -kSimulationTick * gameSpeed * HalfOf(player.GetRotationSpeed());
+					}
+					playerAccelerated = true;
+				}
+				else if (myEngine->KeyHeld(EPlayerIncreaseBackwardThrust))
+				{
+					player.SetThrust(ScalarMulti(-player.GetThrustMultiplier() * kSimulationTick * gameSpeed * player.GetBackwardThrustMulti(), player.GetFacingVector()));
+				}
+				else
+				{
+					player.SetThrust({ 0.0f, 0.0f });
 				}
-				playerAccelerated = true;
-			}
-			else if (myEngine->KeyHeld(EPlayerIncreaseBackwardThrust))
-			{
-				player.SetThrust(ScalarMulti(-player.GetThrustMultiplier() * frametime * gameSpeed * player.GetBackwardThrustMulti(), player.GetFacingVector()));
-			}
-			else
-			{
-				player.SetThrust({ 0.0f, 0.0f });
-			}
 
-			// Calculate the drag based on previous momentum
-			player.SetDrag(ScalarMulti(player.GetDragMultiplier() * frametime * gameSpeed, player.GetMomentum()));
+				// Calculate the drag based on previous momentum
+				player.SetDrag(ScalarMulti(player.GetDragMultiplier() * kSimulationTick * gameSpeed, player.GetMomentum()));
 
-			// Calculate the momentum
-			player.SetMomentum(Sum3(player.GetMomentum(), player.GetThrust(), player.GetDrag()));
+				// Calculate the momentum
+				player.SetMomentum(Sum3(player.GetMomentum(), player.GetThrust(), player.GetDrag()));
 
-			// Move the enemy
-			enemy.GetModel()->LookAt(waypoints.at(enemyWaypointIndex).GetModel());
-			enemy.GetModel()->MoveLocalZ(frametime * gameSpeed * kEnemySpeed);
-			// Then check for collisions with the waypoint
-			if (IsSphereBoxCollided(enemy.GetModel(), 0.0f, 0.0f, enemy.GetRadius(), waypoints.at(enemyWaypointIndex).GetModel(), 1.0f, 1.0f) != ECollisionAxis::none)
-			{
-				enemyWaypointIndex++;
-				if (enemyWaypointIndex == waypoints.size())
+				// Move the enemy
+				enemy.GetModel()->LookAt(waypoints.at(enemyWaypointIndex).GetModel());
+				enemy.GetModel()->MoveLocalZ(kSimulationTick * gameSpeed * kEnemySpeed);
+				// Then check for collisions with the waypoint
+				if (IsSphereBoxCollided(enemy.GetModel(), 0.0f, 0.0f, enemy.GetRadius(), waypoints.at(enemyWaypointIndex).GetModel(), 1.0f, 1.0f) != ECollisionAxis::none)
 				{
-					enemyWaypointIndex = 0;
+					enemyWaypointIndex++;
+					if (enemyWaypointIndex == waypoints.size())
+					{
+						enemyWaypointIndex = 0;
+					}
 				}
-			}
 
-			// Check for collisions against box scenery objects
-			for (const CGameObject& kObject : sceneryBoxObjects)
-			{
-				const EGridVicinity kGridVic = AreGridsClose(player, kObject);
-				if (kGridVic == EGridVicinity::sameGrid || kGridVic == EGridVicinity::closeBy)
+				// Only the colliders the player can reach this frame need testing. The faster it goes, the further it looks.
+				const float kCollisionReach = player.GetCollisionReach(kSimulationTick, gameSpeed);
+
+				// Check for collisions against the box scenery near the player. Runs of isles and walls are merged into one collider each.
+				// The box test looks at where the player was as well as where it is, so find the boxes along the path between them.
+				// Sliding along a box can take the player up to a step to the side of the path, so look at least that far.
+				const float kStepX = player.GetModel()->GetX() - player.GetPreviousX();
+				const float kStepZ = player.GetModel()->GetZ() - player.GetPreviousZ();
+				const float kStepLength = sqrtf(kStepX * kStepX + kStepZ * kStepZ);
+				collisionCandidates.clear();
+				boxBroadphase.QuerySegment(player.GetPreviousX(), player.GetPreviousZ(), player.GetModel()->GetX(), player.GetModel()->GetZ(), max(kCollisionReach, player.GetRadius() + kStepLength), collisionCandidates);
+
+				// Everything the player touches is collected as a contact, and resolved together once every test is done
+				playerContacts.Clear();
+
+				// Sweep the player's last step against the boxes. A fast car, eg. when boosting or after a long frame, can step
+				// right over a wall, so the player is stopped at the first box on its path instead of wherever the step ended.
+				// The box it stops at is a contact to bounce off, and the rest of the step slides along the box.
+				if (kStepLength > 0.0f)
 				{
-					const ECollisionAxis kCollisionAxis = IsSphereBoxCollided(player.GetModel(), player.GetPreviousX(), player.GetPreviousZ(), player.GetRadius(), kObject.GetModel(), HalfOf(kObject.GetWidth()), HalfOf(kObject.GetLength()));
-					switch (kCollisionAxis)
+					float sweepX = player.GetPreviousX();
+					float sweepZ = player.GetPreviousZ();
+					float moveX = kStepX;
+					float moveZ = kStepZ;
+					bool isHit = false;
+					bool isSwept = false; // Set once the rest of the step is clear
+					for (int sweep = 0; sweep < kMaxCollisionSweeps; sweep++)
 					{
-					case ECollisionAxis::xAxis:
+						const SBoxSweep kSweep = SweepCircleBoxes(boxColliders, collisionCandidates.data(), collisionCandidates.size(), sweepX, sweepZ, moveX, moveZ, player.GetRadius());
+						if (kSweep.position == collisionCandidates.size())
+						{
+							isSwept = true;
+							break;
+						}
+						const float kMoveLength = sqrtf(moveX * moveX + moveZ * moveZ);
+						const float kContactTime = max(0.0f, kSweep.time - kCollisionSkin / kMoveLength);
+						sweepX += moveX * kContactTime;
+						sweepZ += moveZ * kContactTime;
+						moveX *= 1.0f - kContactTime;
+						moveZ *= 1.0f - kContactTime;
+						// Slide along the side hit, in the box's own axes
+						const uint32_t kIndex = collisionCandidates[kSweep.position];
+						playerContacts.Add(GetBoxContact(boxColliders, kIndex, sweepX, sweepZ, player.GetRadius(), kSweep.xAxis));
+						const SVector2D kSlide = ScaleAlongBoxAxis({ moveX, moveZ }, boxColliders.GetAxisX()[kIndex], boxColliders.GetAxisZ()[kIndex], kSweep.xAxis, 0.0f);
+						moveX = kSlide.x;
+						moveZ = kSlide.z;
+						isHit = true;
+					}
+					// The player is only moved if it hit something, so a clear step leaves its position exactly as it was
+					if (isHit)
 					{
-						player.SetMomentum( {-HalfOf(player.GetMomentum().x), player.GetMomentum().z} );
-						player.PerformCollision();
-						player.GetModel()->SetX(player.GetPreviousX());
-						player.GetModel()->SetZ(player.GetPreviousZ());
-						break;
+						player.GetModel()->SetX(isSwept ? sweepX + moveX : sweepX);
+						player.GetModel()->SetZ(isSwept ? sweepZ + moveZ : sweepZ);
 					}
-					case ECollisionAxis::zAxis:
+				}
+
+				// A player that is still inside a box, eg. one it started in, is pushed out of the side it came through.
+				// The candidates are tested in blocks straight from the collider arrays, and the search carries on from the
+				// candidate after each hit.
+				const float kPlayerX = player.GetModel()->GetX();
+				const float kPlayerZ = player.GetModel()->GetZ();
+				for (size_t next = 0; next < collisionCandidates.size(); next++)
+				{
+					next += FindFirstBoxHit(boxColliders, collisionCandidates.data() + next, collisionCandidates.size() - next, kPlayerX, kPlayerZ, player.GetRadius());
+					if (next == collisionCandidates.size())
 					{
-						player.SetMomentum( {player.GetMomentum().x, -HalfOf(player.GetMomentum().z)} );
-						player.PerformCollision();
-						player.GetModel()->SetX(player.GetPreviousX());
-						player.GetModel()->SetZ(player.GetPreviousZ());
 						break;
 					}
-					default:
+					// Test the box hit on its own to find which of its sides the player came through
+					const uint32_t kIndex = collisionCandidates[next];
+					const SBoxHits kHit = TestSphereBoxes(boxColliders, &kIndex, 1, kPlayerX, kPlayerZ, player.GetPreviousX(), player.GetPreviousZ(), player.GetRadius());
+					playerContacts.Add(GetBoxContact(boxColliders, kIndex, kPlayerX, kPlayerZ, player.GetRadius(), kHit.xAxis != 0));
+				} // End box scenery object collision checking
+
+				// Check for collisions against the sphere scenery objects near the player, in the same way as the boxes.
+				collisionCandidates.clear();
+				sphereBroadphase.Query(kPlayerX, kPlayerZ, kCollisionReach, collisionCandidates);
+				for (size_t next = 0; next < collisionCandidates.size(); next++)
+				{
+					next += FindFirstSphereHit(sphereColliders, collisionCandidates.data() + next, collisionCandidates.size() - next, kPlayerX, kPlayerZ, player.GetRadius());
+					if (next == collisionCandidates.size())
 					{
 						break;
 					}
-					}
+					const uint32_t kIndex = collisionCandidates[next];
+					playerContacts.Add(GetCircleContact(kPlayerX, kPlayerZ, player.GetRadius(), sphereColliders.GetX()[kIndex], sphereColliders.GetZ()[kIndex], sphereColliders.GetRadius()[kIndex]));
+				} // End sphere scenery object collision checking
+
+				// Check for collisions against the checkpoints and struts near the player
+				collisionCandidates.clear();
+				checkpointBroadphase.Query(kPlayerX, kPlayerZ, kCollisionReach, collisionCandidates);
+
+				// The struts stand outside the gate, so they are tested for every checkpoint nearby, not only the one the
+				// player is passing through. Checkpoint i has struts 2i and 2i + 1.
+				strutCandidates.clear();
+				for (const uint32_t kCheckpoint : collisionCandidates)
+				{
+					strutCandidates.push_back(2 * kCheckpoint);
+					strutCandidates.push_back(2 * kCheckpoint + 1);
 				}
-			} // End box scenery object collision checking
-
-			// Check for collisions against sphere scenery objects.
-			for (const CGameObject& kObject : scenerySphereObjects)
-			{
-				const EGridVicinity kGridVic = AreGridsClose(player, kObject);
-				if (kGridVic == EGridVicinity::sameGrid || kGridVic == EGridVicinity::closeBy)
+				for (size_t next = 0; next < strutCandidates.size(); next++)
 				{
-					if (IsSphereSphereCollided(player.GetModel(), player.GetRadius(), kObject.GetModel(), kObject.GetRadius()))
+					next += FindFirstSphereHit(checkpointStruts, strutCandidates.data() + next, strutCandidates.size() - next, kPlayerX, kPlayerZ, player.GetRadius());
+					if (next == strutCandidates.size())
 					{
-						player.SetMomentum( {-HalfOf(player.GetMomentum().x),  -HalfOf(player.GetMomentum().z)} );
-						
-						player.GetModel()->SetX(player.GetPreviousX());
-						player.GetModel()->SetZ(player.GetPreviousZ());
-
-						player.PerformCollision();
+						break;
 					}
-				}
-			} // End sphere scenery object collision checking
+					const uint32_t kIndex = strutCandidates[next];
+					playerContacts.Add(GetCircleContact(kPlayerX, kPlayerZ, player.GetRadius(), checkpointStruts.GetX()[kIndex], checkpointStruts.GetZ()[kIndex], checkpointStruts.GetRadius()[kIndex]));
+				} // End strut collision checking
 
-			// Check for collisions against checkpoints and struts
-			for (CCheckpoint& checkpoint : checkpoints)
-			{
-				const EGridVicinity kGridVic = AreGridsClose(player, checkpoint);
-				if (kGridVic == EGridVicinity::sameGrid || kGridVic == EGridVicinity::closeBy)
+				for (size_t next = 0; next < collisionCandidates.size(); next++)
 				{
+					next += FindFirstPointBoxHit(checkpointGates, collisionCandidates.data() + next, collisionCandidates.size() - next, kPlayerX, kPlayerZ);
+					if (next == collisionCandidates.size())
+					{
+						break;
+					}
+					const uint32_t kIndex = collisionCandidates[next];
+					CCheckpoint& checkpoint = checkpoints[kIndex];
 					// Check current stage against index of checkpoints
-					if (checkpoint.GetStage() == player.GetCurrentStage() && IsPointBoxCollided(player.GetModel(), checkpoint.GetModel(), HalfOf(checkpoint.GetWidth()), HalfOf(checkpoint.GetLength())))
+					if (checkpoint.GetStage() == player.GetCurrentStage())
 					{
 						if (player.GetCurrentStage() == 0)
 						{
@@ -1413,34 +1746,150 @@ int main()
 						{
 							player.SetCurrentStage(0);
 						}
-						checkpoint.SetCrossLifeTime();						
+						// Move the cross to this checkpoint
+						if (crossCheckpoint < checkpoints.size() && crossCheckpoint != kIndex)
+						{
+							checkpoints[crossCheckpoint].HideCross(cross);
+						}
+						crossCheckpoint = kIndex;
+						checkpoint.SetCrossLifeTime();
 						drawStageText = true;
 						stageTimer = kGameStageTimer;
 					}
+				} // End checkpoint collision checking
+				if (crossCheckpoint < checkpoints.size())
+				{
+					checkpoints[crossCheckpoint].UpdateCross(cross, kSimulationTick, gameSpeed);
+				}
 
-					// Check strut collisions
-					// Being const correct by using a const reference to a vector
-					for (const CGameObject& kStrut : checkpoint.GetStrutVector())
+				// Check collisions between the hover cars. Only the pairs the sweep finds close enough to touch are tested.
+				for (uint32_t i = 0; i < kHoverCars.size(); i++)
+				{
+					carSweep.Update(i, GetColliderBounds(*kHoverCars[i]));
+				}
+				carSweep.FindPairs(carPairs);
+				for (const SBodyPair& kPair : carPairs)
+				{
+					const CHoverCar& kCar1 = *kHoverCars[kPair.first];
+					const CHoverCar& kCar2 = *kHoverCars[kPair.second];
+					// Only the player is moved by momentum, so only the player bounces off. The enemy follows its waypoints.
+					if ((&kCar1 == &player || &kCar2 == &player) && IsSphereSphereCollided(kCar1.GetModel(), kCar1.GetRadius(), kCar2.GetModel(), kCar2.GetRadius()))
 					{
-						if (IsSphereSphereCollided(player.GetModel(), player.GetRadius(), kStrut.GetModel(), checkpoint.GetStrutRadius()))
-						{
-							player.SetMomentum( {-HalfOf(player.GetMomentum().x), -HalfOf(player.GetMomentum().z)} );
-							player.GetModel()->SetX(player.GetPreviousX());
-							player.GetModel()->SetZ(player.GetPreviousZ());
-							player.PerformCollision();
-						}
+						const CHoverCar& kOther = (&kCar1 == &player) ? kCar2 : kCar1;
+						playerContacts.Add(GetCircleContact(kPlayerX, kPlayerZ, player.GetRadius(), kOther.GetModel()->GetX(), kOther.GetModel()->GetZ(), kOther.GetRadius()));
 					}
 				}
-				checkpoint.UpdateCross(cross, frametime, gameSpeed);
-			} // End checkpoint and struts collision checking
 
-			// Check collisions with the enemy
-			if (IsSphereSphereCollided(player.GetModel(), player.GetRadius(), enemy.GetModel(), enemy.GetRadius()))
+				// Resolve everything the player touched at once: one push out of all of it, one bounce off each surface it is
+				// moving into, and one collision for the health
+				if (!playerContacts.IsEmpty())
+				{
+					const SContactResponse kResponse = playerContacts.Resolve(player.GetMomentum().x, player.GetMomentum().z, kCollisionSkin, kContactBounce);
+					player.SetMomentum({ kResponse.momentumX, kResponse.momentumZ });
+					if (kResponse.pushX != 0.0f || kResponse.pushZ != 0.0f)
+					{
+						player.GetModel()->SetX(kPlayerX + kResponse.pushX);
+						player.GetModel()->SetZ(kPlayerZ + kResponse.pushZ);
+					}
+					player.PerformCollision();
+				}
+
+				// Set the previous model positions
+				player.SetPreviousX(player.GetModel()->GetX());
+				player.SetPreviousZ(player.GetModel()->GetZ());
+
+				// Then move the car after checking collisions
+				player.GetModel()->Move(player.GetMomentum().x * kSimulationTick * gameSpeed, 0.0f, player.GetMomentum().z * gameSpeed * kSimulationTick);
+				// Only a car that crossed into another grid square has anything to update
+				for (CHoverCar* car : kHoverCars)
+				{
+					if (car->UpdateGrid() && car == &player)
+					{
+						// The scenery is streamed around the player, so it only changes when the player changes square
+						scenery.Update(player);
+					}
+				}
+				player.UpdateCollisionDelay(kSimulationTick);
+				player.Hover(kSimulationTick, gameSpeed);
+
+				// Check the player's boost
+				// Only apply boost if the player is going forward
+				// Only apply boost if the player is holding down forward key
+				// Not sure which approach is the best
+				if (myEngine->KeyHeld(EPlayerBoostKey) && player.CanUseBoost() && myEngine->KeyHeld(EPlayerIncreaseForwardThrust))
+				{
+					player.Boost(kSimulationTick);
+					if (player.GetBoostTime() >= player.GetBoostMaxTime())
+					{
+						player.BoostOverheat();
+					}
+				}
+				else
+				{
+					player.UpdateBoost(kSimulationTick);
+				}
+
+				// Check if the game should end as the player's health is 0.
+				if (player.GetHealth() <= 0)
+				{
+					gameState = EGameStates::over;
+				}
+
+				// If the player didn't rotate this frame, move the car to the middle
+				if (!playerRotated)
+				{
+					// Set to some threshold else the camera moves back and forth
+					if (static_cast<int>(playerSidewaysRotation) > 0)
+					{
+						player.GetModel()->RotateLocalZ(-kSimulationTick * gameSpeed * player.GetRotationSpeed());
+						playerSidewaysRotation += -kSimulationTick * gameSpeed * player.GetRotationSpeed();
+					}
+					else if (static_cast<int>(playerSidewaysRotation) < 0)
+					{
+						player.GetModel()->RotateLocalZ(kSimulationTick * gameSpeed * player.GetRotationSpeed());
+						playerSidewaysRotation += kSimulationTick * gameSpeed * player.GetRotationSpeed();
+					}
+				}
+
+				if (!playerAccelerated)
+				{
+					if (static_cast<int>(playerAccelerationRotation) < 0)
+					{
+						player.GetModel()->RotateLocalX(kSimulationTick * gameSpeed * player.GetRotationSpeed());
+						playerAccelerationRotation += kSimulationTick * gameSpeed * player.GetRotationSpeed();
+					}
+				}
+
+				playerRotated = false;
+				playerAccelerated = false;
+			} // End simulation ticks
+
+			// Show the cars part of the way between the last two ticks, for the time left over
+			for (CHoverCar* car : kHoverCars)
+			{
+				car->ShowBetweenTicks(simulationClock.GetInterpolation());
+			}
+			isShowingBetweenTicks = true;
+
+			if (drawCountdownText)
+			{
+				myFont->Draw(to_string(static_cast<int>(ceilf(countdownTimer))), kHUDCountdown.x, kHUDCountdown.y);
+				break;
+			}
+			else if (drawGoText)
+			{
+				myFont->Draw(kGoInstruction, kHUDGo.x, kHUDGo.y);
+			}
+			else if (drawStageText)
 			{
-				player.PerformCollision();
-				player.SetMomentum({ -HalfOf(player.GetMomentum().x), -HalfOf(player.GetMomentum().z) });
-				player.GetModel()->SetX(player.GetPreviousX());
-				player.GetModel()->SetZ(player.GetPreviousZ());
+				if (player.GetCurrentStage() == 0)
+				{
+					myFont->Draw("Stage " + to_string(checkpoints.size() - 1) + " Complete!", kHUDStageComplete.x, kHUDStageComplete.y);
+				}
+				else
+				{
+					myFont->Draw("Stage " + to_string(player.GetCurrentStage() - 1) + " Complete!", kHUDStageComplete.x, kHUDStageComplete.y);
+				}
 			}
 
 			if (!drawGoText)
@@ -1463,70 +1912,15 @@ int main()
 				myFont->Draw("Boost Overheated!!!", kHUDBoostWarning.x, kHUDBoostWarning.y);
 			}
 
-			// Set the previous model positions
-			player.SetPreviousX(player.GetModel()->GetX());
-			player.SetPreviousZ(player.GetModel()->GetZ());
-
-			// Then move the car after checking collisions
-			player.GetModel()->Move(player.GetMomentum().x * frametime * gameSpeed, 0.0f, player.GetMomentum().z * gameSpeed * frametime);
-			player.UpdateGrid();
-			player.UpdateCollisionDelay(frametime);
-			player.Hover(frametime, gameSpeed);
-
-			// Check the player's boost
-			// Only apply boost if the player is going forward
-			// Only apply boost if the player is holding down forward key
-			// Not sure which approach is the best
-			if (myEngine->KeyHeld(EPlayerBoostKey) && player.CanUseBoost() && myEngine->KeyHeld(EPlayerIncreaseForwardThrust))
-			{
-				player.Boost(frametime);
-				if (player.GetBoostTime() >= player.GetBoostMaxTime())
-				{
-					player.BoostOverheat();
-				}
-			}
-			else
-			{
-				player.UpdateBoost(frametime);
-			}
-
-			// Check if the game should end as the player's health is 0.
-			if (player.GetHealth() <= 0)
-			{
-				gameState = EGameStates::over;
-			}
-
-			// If the player didn't rotate this frame, move the car to the middle
-			if (!playerRotated)
-			{
-				// Set to some threshold else the camera moves back and forth
-				if (static_cast<int>(playerSidewaysRotation) > 0)
-				{
-					player.GetModel()->RotateLocalZ(-frametime * gameSpeed * player.GetRotationSpeed());
-					playerSidewaysRotation += -frametime * gameSpeed * player.GetRotationSpeed();
-				}
-				else if (static_cast<int>(playerSidewaysRotation) < 0)
-				{
-					player.GetModel()->RotateLocalZ(frametime * gameSpeed * player.GetRotationSpeed());
-					playerSidewaysRotation += frametime * gameSpeed * player.GetRotationSpeed();
-				}
-			}
-
-			if (!playerAccelerated)
+			if (myEngine->KeyHit(EGamePause))
 			{
-				if (static_cast<int>(playerAccelerationRotation) < 0)
-				{
-					player.GetModel()->RotateLocalX(frametime * gameSpeed * player.GetRotationSpeed());
-					playerAccelerationRotation += frametime * gameSpeed * player.GetRotationSpeed();
-				}
+				gameState = EGameStates::paused;
 			}
 
-			playerRotated = false;
-			playerAccelerated = false;
-
-			if (myEngine->KeyHit(EGamePause))
+			// Read the next level in the background during the race, so it is ready when this one finishes.
+			if (levelIndex + 1 < levels.size() && !levelLoader.IsStarted())
 			{
-				gameState = EGameStates::paused;
+				levelLoader.Start(levels.at(levelIndex + 1));
 			}
 
 			break;
@@ -1550,6 +1944,40 @@ int main()
 		case EGameStates::finished:
 		{
 			myFont->Draw("You have finished the race.", kHUDCurrentStage.x, kHUDCurrentStage.y);
+			if (levelIndex + 1 < levels.size())
+			{
+				myFont->Draw(kNextLevelInstruction, kHUDInstruction.x, kHUDInstruction.y);
+				if (myEngine->KeyHit(EGameStartKey))
+				{
+					// Swap to the next level. It was read during the race, so only the models need creating. If some other
+					// level is being read instead, it is thrown away and the next level is read now.
+					levelIndex++;
+					if (!levelLoader.Start(levels.at(levelIndex)))
+					{
+						levelLoader.Take();
+						levelLoader.Start(levels.at(levelIndex));
+					}
+					RemoveRaceObjects(meshes, cross, checkpoints, waypoints);
+					isLevelRead = false;
+
+					// The next race starts as the first one did. The player's health and boost carry over, as the levels are
+					// one run: damage taken in one race still counts in the next. The cars start level, the cross is on no
+					// checkpoint of the new level, and the time left over from the last tick is dropped, as the cars have
+					// just been put back at the start.
+					ResetHoverCar(player, kPlayerStartPos);
+					ResetHoverCar(enemy, kEnemyStartPos);
+					playerSidewaysRotation = 0.0f;
+					playerAccelerationRotation = 0.0f;
+					crossCheckpoint = numeric_limits<size_t>::max();
+					simulationClock.Reset();
+					enemyWaypointIndex = 0;
+					currentLap = 0;
+					countdownTimer = kGameCountdownTimer;
+					goTimer = kGameGoTimer;
+					drawStageText = false;
+					gameState = EGameStates::loading;
+				}
+			}
 			break;
 		}
 		default:
@@ -1561,29 +1989,31 @@ int main()
 		// Camera controls
 
 		// The camera can't move forward beyond half of the player's length in the z axis
-		if (myEngine->KeyHeld(ECameraForward) && myCamera->GetLocalZ() < HalfOf(player.GetLength()))
+		if (myEngine->KeyHeld(ECameraForward) && cameraOffset[z3D] < HalfOf(player.GetLength()))
 		{
-			myCamera->MoveLocalZ(frametime * kCameraSpeed * gameSpeed);
+			cameraOffset[z3D] += frametime * kCameraSpeed * gameSpeed;
 		}
 		// The camera can't go further behind that it's initial position
-		else if (myEngine->KeyHeld(ECameraBackward) && myCamera->GetLocalZ() > kCameraPos[z3D])
+		else if (myEngine->KeyHeld(ECameraBackward) && cameraOffset[z3D] > kCameraPos[z3D])
 		{
-			myCamera->MoveZ(-frametime * kCameraSpeed * gameSpeed);
+			cameraOffset[z3D] -= frametime * kCameraSpeed * gameSpeed;
 		}
 		// The camera can't go sideways more than half of the initial z position.
-		else if (myEngine->KeyHeld(ECameraLeft) && myCamera->GetLocalX() > HalfOf(kCameraPos[z3D]))
+		else if (myEngine->KeyHeld(ECameraLeft) && cameraOffset[x3D] > HalfOf(kCameraPos[z3D]))
 		{
-			myCamera->MoveLocalX(-frametime * kCameraSpeed * gameSpeed);
+			cameraOffset[x3D] -= frametime * kCameraSpeed * gameSpeed;
 		}
-		else if (myEngine->KeyHeld(ECameraRight) && myCamera->GetLocalX() < HalfOf(-kCameraPos[z3D]))
+		else if (myEngine->KeyHeld(ECameraRight) && cameraOffset[x3D] < HalfOf(-kCameraPos[z3D]))
 		{
-			myCamera->MoveLocalX(frametime * kCameraSpeed * gameSpeed);
+			cameraOffset[x3D] += frametime * kCameraSpeed * gameSpeed;
 		}
 		else if (myEngine->KeyHit(ECameraReset))
 		{
 			cameraRotationX = 0.0f;
 			cameraRotationY = 0.0f;
-			myCamera->SetLocalPosition(kCameraPos[x3D], kCameraPos[y3D], kCameraPos[z3D]);
+			cameraOffset[x3D] = kCameraPos[x3D];
+			cameraOffset[y3D] = kCameraPos[y3D];
+			cameraOffset[z3D] = kCameraPos[z3D];
 			myCamera->ResetOrientation();
 		}
 		else if (myEngine->KeyHit(ECameraFirstPerson))
@@ -1593,10 +2023,18 @@ int main()
 			constexpr float kX = 0.0f;
 			constexpr float kY = 2.5f; // Height of first person camera
 			const float kZ = HalfOf(player.GetLength()) - 4.0f;
-			myCamera->SetLocalPosition(kX, kY, kZ);
+			cameraOffset[x3D] = kX;
+			cameraOffset[y3D] = kY;
+			cameraOffset[z3D] = kZ;
 			myCamera->ResetOrientation();
 		}
 
+		// The camera hangs off the player on an arm. When the scenery gets between them the arm is pulled in at once,
+		// so the camera never ends up inside a wall, then eases back out once the way is clear.
+		const float kClearCameraArm = GetClearCameraArm(sceneryCaster, player, cameraOffset);
+		cameraArm = (kClearCameraArm < cameraArm) ? kClearCameraArm : min(kClearCameraArm, cameraArm + frametime * kCameraArmSpeed * gameSpeed);
+		myCamera->SetLocalPosition(cameraOffset[x3D] * cameraArm, cameraOffset[y3D] * cameraArm, cameraOffset[z3D] * cameraArm);
+
 		// Mouse control for camera on the rotation on the y axis. Camera looks sideways.
 		// +ve to the right
 		// -ve to the left
@@ -1625,6 +2063,51 @@ int main()
 			myCamera->RotateLocalX(frametime * kCameraSpeed * gameSpeed * mouseMovementY);
 		}
 		
+		// Keep creating the scenery around the player. The loading state does this itself.
+		if (gameState != EGameStates::loading)
+		{
+			scenery.CreatePendingModels(kModelsPerFrame);
+		}
+
+		// Apply edits to the level file without restarting. Only the objects that changed are recreated.
+		if (gameState != EGameStates::loading && levelWatcher.HasChanged())
+		{
+			const auto kReloadStart = chrono::steady_clock::now();
+			SLoadedLevel editedLevel = ReloadLevel(levelWatcher.GetLevelFile());
+			if (!editedLevel.succeeded)
+			{
+				cout << "ERROR: " << editedLevel.error.message << ". Line " << editedLevel.error.line << ", Column " << editedLevel.error.column << "\n";
+				cout << "Check the " << editedLevel.levelFile << " file. Keeping the current level." << endl;
+			}
+			else
+			{
+				const size_t kChangedRaceObjects = UpdateRaceObjects(meshes, cross, currentLevel.raceObjects, editedLevel.raceObjects, checkpoints, waypoints);
+				sphereColliders.AssignSpheres(editedLevel.scenery.GetObjects(), editedLevel.scenery.GetObjects() + editedLevel.scenery.GetObjectCount());
+				BuildBroadphase(sphereColliders, sphereBroadphase);
+				const size_t kChangedSectors = scenery.ReplaceLevel(move(editedLevel.scenery));
+				boxColliders.AssignBoxes(editedLevel.boxColliders);
+				BuildBroadphase(boxColliders, boxBroadphase);
+				AssignCheckpointGates(checkpoints, checkpointGates, checkpointStruts);
+				BuildBroadphase(checkpoints, checkpointBroadphase);
+				currentLevel.raceObjects = move(editedLevel.raceObjects);
+				scenery.Update(player);
+				scenery.CreatePendingModels(kModelsPerFrame);
+
+				// The race may have lost the checkpoint or waypoint it was heading for
+				if (player.GetCurrentStage() >= checkpoints.size())
+				{
+					player.SetCurrentStage(0);
+				}
+				if (enemyWaypointIndex >= waypoints.size())
+				{
+					enemyWaypointIndex = 0;
+				}
+
+				const chrono::duration<double, milli> kReloadTime = chrono::steady_clock::now() - kReloadStart;
+				cout << "Reloaded " << editedLevel.levelFile << " in " << kReloadTime.count() << " ms: " << kChangedRaceObjects << " checkpoints/waypoints and " << kChangedSectors << " scenery sectors changed." << endl;
+			}
+		}
+
 		// Controls and toggles
 		if (myEngine->KeyHit(EGameExit))
 		{
@@ -1637,6 +2120,8 @@ int main()
 		}
 	}
 
+	meshes.PrintReport(cout);
+
 	// Delete the 3D engine now we are finished with it
 	myEngine->Delete();
 	return CodeSuccess;
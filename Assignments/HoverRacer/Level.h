@@ -0,0 +1,232 @@
+#pragma once
+#include <array> // Fixed size array of struts
+#include <cstdint> // Fixed width integers for the level records
+#include <limits> // maximum data type values
+#include <string_view> // Object names without copying
+
+// Shared description of the objects a level is made from.
+// Used by every level loader (text, binary and compile-time) so they all produce the same records.
+// Everything here is constexpr so levels embedded in the game can be checked by the compiler.
+
+// What items is the level file made from
+enum EGameFileIndexes
+{
+	objectIndex,
+	xPosIndex,
+	yPosIndex,
+	zPosIndex,
+	globalXRotationIndex,
+	globalYRotationIndex,
+	globalZRotationIndex,
+	localXRotationIndex,
+	localYRotationIndex,
+	localZRotationIndex,
+	scaleIndex,
+
+	fileIndexesTotal
+};
+
+// Every type of object that can be placed in a level
+enum ELevelObjectType : uint32_t
+{
+	objectCheckpoint,
+	objectIsleStraight,
+	objectWall,
+	objectWaterTank,
+	objectWaypoint,
+
+	objectTypesTotal
+};
+
+// Names used for each object type in the level file
+constexpr std::string_view kCheckpointObject = "Checkpoint";
+constexpr std::string_view kIsleStraightObject = "Isle";
+constexpr std::string_view kWallObject = "Wall";
+constexpr std::string_view kWaypointObject = "Waypoint";
+constexpr std::string_view kWaterTankObject = "WaterTank";
+
+// Collision measurements of each object type
+constexpr float kCheckpointWidth = 19.0f;
+constexpr float kCheckpointLength = 2.0f;
+constexpr float kStrutRadius = 1.2f; // 1.25f
+// The checkpoint width includes the struct diameter * 2; struct radius * 4;
+constexpr float kCheckpointWidthNoStruts = kCheckpointWidth - (4.0f * kStrutRadius);
+constexpr float kIsleStraightLength = 7.0f;
+constexpr float kIsleStraightWidth = 4.5f; // 5.0f
+constexpr float kWallLength = 10.0f;
+constexpr float kWallWidth = 4.5f; // 1.5f
+constexpr float kTankRadius = 4.5f;
+
+// How big each grid square is. x * x dimensions.
+// Collision and level streaming both work on this grid.
+constexpr unsigned int kGridSize = 50;
+
+// Get the grid square a world coordinate is in. Squares are centred on multiples of kGridSize.
+constexpr int GetGridIndex(const float& kCoordinate) noexcept
+{
+	// Round half away from zero, the same as std::round
+	const float kSquares = (kCoordinate < 0.0f ? -kCoordinate : kCoordinate) / kGridSize;
+	const int kIndex = static_cast<int>(kSquares + 0.5f);
+	return (kCoordinate < 0.0f) ? -kIndex : kIndex;
+}
+
+// Global Y rotations that keep a box lined up with the world axes, in degrees.
+constexpr float kRightAngle = 90.0f;
+constexpr float kCircle = 360.0f;
+
+// Check if a global y rotation keeps a box lined up with the world axes. Such boxes are stored with their width and
+// length swapped if needed, and collide as axis-aligned boxes. Boxes turned by any other angle are oriented boxes.
+constexpr bool IsRightAngleRotation(const float& kRotation) noexcept
+{
+	return kRotation == 0.0f || kRotation == kRightAngle || kRotation == 2.0f * kRightAngle || kRotation == (kCircle - kRightAngle) || kRotation == kCircle;
+}
+
+// The direction of a box's own x axis on the ground, as a unit vector. Its own z axis is at a right angle: -z, x.
+// An axis-aligned box has 1, 0.
+struct SBoxAxis
+{
+	float x;
+	float z;
+};
+
+// One object from a level, as stored in a binary level file.
+// Fixed size and trivially copyable so a file of them can be used straight from memory.
+struct SLevelObject
+{
+	ELevelObjectType type; // What the object is
+	float position[3]; // x, y, z
+	float globalRotation[3]; // Rotation around the world x, y and z axes in degrees
+	float localRotation[3]; // Rotation around the model's own x, y and z axes in degrees
+	float scale; // Uniform scale
+	// Collision size on the x axis, after the global y rotation if it is a right angle. An object turned by any other
+	// angle keeps the size on its own x axis. Negative if the object has no box.
+	float width;
+	float length; // Collision size on the z axis, the same way as width. Negative if the object has no box.
+	float radius; // Collision radius. Negative if the object has no sphere.
+};
+
+// Get the name of an object type as written in the level file.
+constexpr std::string_view GetLevelObjectName(const ELevelObjectType& kType) noexcept
+{
+	switch (kType)
+	{
+	case ELevelObjectType::objectCheckpoint:
+		return kCheckpointObject;
+	case ELevelObjectType::objectIsleStraight:
+		return kIsleStraightObject;
+	case ELevelObjectType::objectWall:
+		return kWallObject;
+	case ELevelObjectType::objectWaterTank:
+		return kWaterTankObject;
+	case ELevelObjectType::objectWaypoint:
+		return kWaypointObject;
+	default:
+		return "Unknown";
+	}
+}
+
+// Find the object type from its name in the level file. Returns false if the name is not recognised.
+constexpr bool GetLevelObjectType(const std::string_view& kName, ELevelObjectType& type) noexcept
+{
+	for (uint32_t i = 0; i < ELevelObjectType::objectTypesTotal; i++)
+	{
+		if (kName == GetLevelObjectName(static_cast<ELevelObjectType>(i)))
+		{
+			type = static_cast<ELevelObjectType>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+// Fill in the width, length and radius of an object from its type and global y rotation.
+constexpr void SetLevelObjectExtents(SLevelObject& object) noexcept
+{
+	// Set to known bad values, so objects without a box or sphere are never mistaken for one.
+	object.width = -std::numeric_limits<float>::max();
+	object.length = -std::numeric_limits<float>::max();
+	object.radius = -std::numeric_limits<float>::max();
+
+	switch (object.type)
+	{
+	case ELevelObjectType::objectCheckpoint:
+	{
+		object.length = kCheckpointLength;
+		object.width = kCheckpointWidthNoStruts;
+		break;
+	}
+	case ELevelObjectType::objectIsleStraight:
+	{
+		object.width = kIsleStraightWidth;
+		object.length = kIsleStraightLength;
+		break;
+	}
+	case ELevelObjectType::objectWall:
+	{
+		object.width = kWallWidth;
+		object.length = kWallLength;
+		break;
+	}
+	case ELevelObjectType::objectWaterTank:
+	{
+		object.radius = kTankRadius;
+		break;
+	}
+	default:
+	{
+		break;
+	}
+	}
+
+	// If the object is rotated by a right angle, rotate the bounding box with it, so it stays axis aligned.
+	// Other angles keep the box in the object's own axes, and it is turned when colliders are built.
+	const float kRotation = object.globalRotation[1];
+	if (kRotation == kRightAngle || kRotation == (kCircle - kRightAngle))
+	{
+		const float kLength = object.length;
+		object.length = object.width;
+		object.width = kLength;
+	}
+}
+
+// Where one of a checkpoint's struts stands. Struts are spheres of kStrutRadius.
+struct SStrut
+{
+	float x;
+	float z;
+};
+
+// The struts at either end of a checkpoint
+using SCheckpointStruts = std::array<SStrut, 2>;
+
+// Get the positions of the struts at either end of a checkpoint, from its position, extents and own x axis.
+constexpr SCheckpointStruts GetCheckpointStruts(const SLevelObject& kCheckpoint, const SBoxAxis& kAxis) noexcept
+{
+	constexpr float kOffset = kCheckpointWidthNoStruts / 2.0f + kStrutRadius;
+	const float kX = kCheckpoint.position[0];
+	const float kZ = kCheckpoint.position[2];
+	// A checkpoint turned by any other angle has its gate along its own x axis
+	if (!IsRightAngleRotation(kCheckpoint.globalRotation[1]))
+	{
+		return { { { kX - kOffset * kAxis.x, kZ - kOffset * kAxis.z }, { kX + kOffset * kAxis.x, kZ + kOffset * kAxis.z } } };
+	}
+	// A checkpoint rotated by a right angle has its gate along the z axis
+	if (kCheckpoint.length > kCheckpoint.width)
+	{
+		return { { { kX, kZ + kOffset }, { kX, kZ - kOffset } } };
+	}
+	return { { { kX - kOffset, kZ }, { kX + kOffset, kZ } } };
+}
+
+// Check if two objects are exactly the same, eg. to find the objects changed by an edit to a level.
+constexpr bool IsSameLevelObject(const SLevelObject& kObject1, const SLevelObject& kObject2) noexcept
+{
+	for (int i = 0; i < 3; i++)
+	{
+		if (kObject1.position[i] != kObject2.position[i] || kObject1.globalRotation[i] != kObject2.globalRotation[i] || kObject1.localRotation[i] != kObject2.localRotation[i])
+		{
+			return false;
+		}
+	}
+	return kObject1.type == kObject2.type && kObject1.scale == kObject2.scale;
+}
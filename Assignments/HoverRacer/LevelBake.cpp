@@ -0,0 +1,124 @@
+#include "LevelBake.h"
+#include <cstring> // memcmp, memcpy
+#include <filesystem> // Changing the file extension
+#include <fstream> // File output
+#include <type_traits> // is_trivially_copyable
+#include <vector> // Vector class
+#include "LevelBinary.h" // CMappedFile
+
+static_assert(std::is_trivially_copyable<SRaceObject>::value, "Race objects are written and mapped as raw memory.");
+static_assert(std::is_trivially_copyable<SLevelSector>::value, "Sectors are written and mapped as raw memory.");
+static_assert(std::is_trivially_copyable<SBoxCollider>::value, "Colliders are written and mapped as raw memory.");
+static_assert(sizeof(SBakedLevelHeader) == 64, "The header size is part of the file format.");
+// Every section starts where the one before it ends, so each record size must keep the next section aligned.
+static_assert(sizeof(SRaceObject) % alignof(SLevelSector) == 0 && sizeof(SLevelObject) % alignof(SLevelSector) == 0
+	&& sizeof(SLevelSector) % alignof(SBoxCollider) == 0, "Sections must stay aligned after each other.");
+
+namespace
+{
+	template <typename Record>
+	void WriteSection(std::ofstream& outputStream, const Record* kRecords, const size_t& kCount)
+	{
+		outputStream.write(reinterpret_cast<const char*>(kRecords), static_cast<std::streamsize>(sizeof(Record) * kCount));
+	}
+
+	// Get the next section of a mapped file and move past it. Returns nullptr if the file is too short.
+	template <typename Record>
+	const Record* ReadSection(const unsigned char*& current, const unsigned char* kEnd, const uint64_t& kCount)
+	{
+		if (kCount > static_cast<uint64_t>(kEnd - current) / sizeof(Record))
+		{
+			return nullptr;
+		}
+		const Record* kRecords = reinterpret_cast<const Record*>(current);
+		current += sizeof(Record) * kCount;
+		return kRecords;
+	}
+}
+
+std::string GetBakedLevelFile(const std::string& kLevelFile)
+{
+	return std::filesystem::path(kLevelFile).replace_extension(kBakedLevelExtension).string();
+}
+
+bool WriteBakedLevel(const std::string& kBakedFile, const SLoadedLevel& kLevel)
+{
+	const std::vector<SLevelSector> kSectors = kLevel.scenery.GetSectors();
+
+	// Write to a temporary file first so a running game never reads a half-written level.
+	const std::string kTemporaryFile = kBakedFile + ".tmp";
+	{
+		std::ofstream outputStream(kTemporaryFile, std::ios::binary | std::ios::trunc);
+		if (!outputStream)
+		{
+			return false;
+		}
+		SBakedLevelHeader header{};
+		memcpy(header.magic, kBakedLevelMagic, sizeof(kBakedLevelMagic));
+		header.version = kBakedLevelVersion;
+		header.raceObjectSize = sizeof(SRaceObject);
+		header.sceneryObjectSize = sizeof(SLevelObject);
+		header.sectorSize = sizeof(SLevelSector);
+		header.colliderSize = sizeof(SBoxCollider);
+		header.raceObjectCount = kLevel.raceObjects.size();
+		header.sceneryObjectCount = kLevel.scenery.GetObjectCount();
+		header.sectorCount = kSectors.size();
+		header.colliderCount = kLevel.boxColliders.size();
+		header.boxPieces = kLevel.boxPieces;
+		outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		WriteSection(outputStream, kLevel.raceObjects.data(), kLevel.raceObjects.size());
+		WriteSection(outputStream, kLevel.scenery.GetObjects(), kLevel.scenery.GetObjectCount());
+		WriteSection(outputStream, kSectors.data(), kSectors.size());
+		WriteSection(outputStream, kLevel.boxColliders.data(), kLevel.boxColliders.size());
+		if (!outputStream)
+		{
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(kTemporaryFile, kBakedFile, error);
+	return !error;
+}
+
+bool ReadBakedLevel(const std::string& kBakedFile, SLoadedLevel& level)
+{
+	CMappedFile file;
+	if (!file.Open(kBakedFile) || file.size() < sizeof(SBakedLevelHeader))
+	{
+		return false;
+	}
+
+	// Check the header before trusting any of the sections.
+	const SBakedLevelHeader* kHeader = reinterpret_cast<const SBakedLevelHeader*>(file.data());
+	if (memcmp(kHeader->magic, kBakedLevelMagic, sizeof(kBakedLevelMagic)) != 0
+		|| kHeader->version != kBakedLevelVersion
+		|| kHeader->raceObjectSize != sizeof(SRaceObject)
+		|| kHeader->sceneryObjectSize != sizeof(SLevelObject)
+		|| kHeader->sectorSize != sizeof(SLevelSector)
+		|| kHeader->colliderSize != sizeof(SBoxCollider))
+	{
+		return false;
+	}
+	const unsigned char* current = file.data() + sizeof(SBakedLevelHeader);
+	const unsigned char* kEnd = file.data() + file.size();
+	const SRaceObject* kRaceObjects = ReadSection<SRaceObject>(current, kEnd, kHeader->raceObjectCount);
+	const SLevelObject* kSceneryObjects = ReadSection<SLevelObject>(current, kEnd, kHeader->sceneryObjectCount);
+	const SLevelSector* kSectors = ReadSection<SLevelSector>(current, kEnd, kHeader->sectorCount);
+	const SBoxCollider* kColliders = ReadSection<SBoxCollider>(current, kEnd, kHeader->colliderCount);
+	if (kRaceObjects == nullptr || kSceneryObjects == nullptr || kSectors == nullptr || kColliders == nullptr || current != kEnd)
+	{
+		return false;
+	}
+
+	CLevelSectors scenery;
+	const size_t kSectorCount = static_cast<size_t>(kHeader->sectorCount);
+	if (!scenery.AssignGrouped(kSceneryObjects, static_cast<size_t>(kHeader->sceneryObjectCount), kSectors, kSectors + kSectorCount))
+	{
+		return false;
+	}
+	level.raceObjects.assign(kRaceObjects, kRaceObjects + kHeader->raceObjectCount);
+	level.scenery = std::move(scenery);
+	level.boxColliders.assign(kColliders, kColliders + kHeader->colliderCount);
+	level.boxPieces = static_cast<size_t>(kHeader->boxPieces);
+	return true;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint> // Fixed width integers for the file header
+#include <string> // String class
+#include "LevelLoader.h" // SLoadedLevel
+
+// Baked level files (.glbk)
+// A level that Tools/LevelBaker has already checked and prepared: checkpoints and waypoints with their grid squares and
+// struts, the scenery grouped into sectors with the sector index, and the merged box colliders.
+// Loading one only copies the sections out of the mapped file; nothing is parsed, sorted or merged.
+
+constexpr char kBakedLevelMagic[4]{ 'G', 'L', 'B', 'K' };
+constexpr uint32_t kBakedLevelVersion = 4; // Increase when any record, the header or the way colliders are merged changes.
+const std::string kBakedLevelExtension = ".glbk";
+
+// The sections follow the header in this order, each an array of records.
+struct SBakedLevelHeader
+{
+	char magic[4]; // Always kBakedLevelMagic
+	uint32_t version; // kBakedLevelVersion when the file was written
+	uint32_t raceObjectSize; // sizeof(SRaceObject) when the file was written
+	uint32_t sceneryObjectSize; // sizeof(SLevelObject) when the file was written
+	uint32_t sectorSize; // sizeof(SLevelSector) when the file was written
+	uint32_t colliderSize; // sizeof(SBoxCollider) when the file was written
+	uint64_t raceObjectCount; // Checkpoints and waypoints, in level order
+	uint64_t sceneryObjectCount; // Isles, walls and water tanks, grouped by sector
+	uint64_t sectorCount; // Sectors, sorted by key
+	uint64_t colliderCount; // Merged box colliders
+	uint64_t boxPieces; // How many isles and walls the colliders were built from
+};
+
+// Get the baked file for a level file, eg. level1.glf -> level1.glbk
+std::string GetBakedLevelFile(const std::string& kLevelFile);
+// Write a prepared level to a baked level file. Returns false if the file can't be written.
+bool WriteBakedLevel(const std::string& kBakedFile, const SLoadedLevel& kLevel);
+// Read the race objects, scenery and colliders of a baked level file into level.
+// Returns false, and leaves level as it was, if the file is missing, damaged or from another version.
+bool ReadBakedLevel(const std::string& kBakedFile, SLoadedLevel& level);
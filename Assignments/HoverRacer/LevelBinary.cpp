@@ -0,0 +1,178 @@
+#include "LevelBinary.h"
+#include <cstring> // memcmp
+#include <fstream> // File output
+#include <filesystem> // File timestamps
+#include <type_traits> // is_trivially_copyable
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h> // File mapping
+#else
+#include <fcntl.h> // open
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <unistd.h> // close
+#endif
+
+static_assert(std::is_trivially_copyable<SLevelObject>::value, "Level records are written and mapped as raw memory.");
+static_assert(sizeof(SBinaryLevelHeader) == 24, "The header size is part of the file format.");
+static_assert(sizeof(SBinaryLevelHeader) % alignof(SLevelObject) == 0, "Records must stay aligned after the header.");
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+bool CMappedFile::Open(const std::string& kFile)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(kFile.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+	const void* kView = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (kView == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+	file_ = file;
+	mapping_ = mapping;
+	data_ = static_cast<const unsigned char*>(kView);
+	size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+	const int kDescriptor = open(kFile.c_str(), O_RDONLY);
+	if (kDescriptor < 0)
+	{
+		return false;
+	}
+	struct stat fileInfo;
+	if (fstat(kDescriptor, &fileInfo) != 0 || fileInfo.st_size == 0)
+	{
+		close(kDescriptor);
+		return false;
+	}
+	void* view = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, kDescriptor, 0);
+	// The mapping keeps its own reference to the file.
+	close(kDescriptor);
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+	data_ = static_cast<const unsigned char*>(view);
+	size_ = static_cast<size_t>(fileInfo.st_size);
+#endif
+	return true;
+}
+
+void CMappedFile::Close() noexcept
+{
+	if (data_ != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(data_);
+		CloseHandle(mapping_);
+		CloseHandle(file_);
+		mapping_ = nullptr;
+		file_ = nullptr;
+#else
+		munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+	}
+	data_ = nullptr;
+	size_ = 0;
+}
+
+bool CMappedLevel::Open(const std::string& kBinaryFile)
+{
+	Close();
+	if (!file_.Open(kBinaryFile))
+	{
+		return false;
+	}
+
+	// Check the header before trusting any of the records.
+	const size_t kSize = file_.size();
+	const SBinaryLevelHeader* kHeader = reinterpret_cast<const SBinaryLevelHeader*>(file_.data());
+	if (kSize < sizeof(SBinaryLevelHeader)
+		|| memcmp(kHeader->magic, kBinaryLevelMagic, sizeof(kBinaryLevelMagic)) != 0
+		|| kHeader->version != kBinaryLevelVersion
+		|| kHeader->recordSize != sizeof(SLevelObject)
+		|| kHeader->objectCount != (kSize - sizeof(SBinaryLevelHeader)) / sizeof(SLevelObject)
+		|| (kSize - sizeof(SBinaryLevelHeader)) % sizeof(SLevelObject) != 0)
+	{
+		Close();
+		return false;
+	}
+	objects_ = reinterpret_cast<const SLevelObject*>(file_.data() + sizeof(SBinaryLevelHeader));
+	objectCount_ = static_cast<size_t>(kHeader->objectCount);
+	return true;
+}
+
+void CMappedLevel::Close() noexcept
+{
+	file_.Close();
+	objects_ = nullptr;
+	objectCount_ = 0;
+}
+
+std::string GetBinaryLevelFile(const std::string& kLevelFile)
+{
+	return std::filesystem::path(kLevelFile).replace_extension(kBinaryLevelExtension).string();
+}
+
+bool IsBinaryLevelCurrent(const std::string& kLevelFile, const std::string& kBinaryFile)
+{
+	std::error_code error;
+	const auto kBinaryTime = std::filesystem::last_write_time(kBinaryFile, error);
+	if (error)
+	{
+		return false;
+	}
+	const auto kLevelTime = std::filesystem::last_write_time(kLevelFile, error);
+	// A binary level shipped without its text file is still usable.
+	return error || kBinaryTime >= kLevelTime;
+}
+
+bool WriteBinaryLevel(const std::string& kBinaryFile, const SLevelObject* kFirst, const SLevelObject* kLast)
+{
+	// Write to a temporary file first so a running game never maps a half-written level.
+	const std::string kTemporaryFile = kBinaryFile + ".tmp";
+	{
+		std::ofstream outputStream(kTemporaryFile, std::ios::binary | std::ios::trunc);
+		if (!outputStream)
+		{
+			return false;
+		}
+		SBinaryLevelHeader header{};
+		memcpy(header.magic, kBinaryLevelMagic, sizeof(kBinaryLevelMagic));
+		header.version = kBinaryLevelVersion;
+		header.recordSize = sizeof(SLevelObject);
+		header.objectCount = static_cast<uint64_t>(kLast - kFirst);
+		outputStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		outputStream.write(reinterpret_cast<const char*>(kFirst), static_cast<std::streamsize>(sizeof(SLevelObject) * (kLast - kFirst)));
+		if (!outputStream)
+		{
+			return false;
+		}
+	}
+	std::error_code error;
+	std::filesystem::rename(kTemporaryFile, kBinaryFile, error);
+	return !error;
+}
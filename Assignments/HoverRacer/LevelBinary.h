@@ -0,0 +1,91 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for the file header
+#include <string> // String class
+#include <vector> // Vector class
+#include "Level.h" // SLevelObject
+
+// Binary level files (.glfb)
+// A precompiled copy of a .glf level: a small header followed by an array of SLevelObject records.
+// The file is memory-mapped and the records are used in place, so loading does no parsing at all.
+// The .glf text file stays the authoring format; the .glfb is rebuilt whenever it is older than the .glf.
+
+constexpr char kBinaryLevelMagic[4]{ 'G', 'L', 'F', 'B' };
+constexpr uint32_t kBinaryLevelVersion = 1; // Increase when SLevelObject or the header changes.
+const std::string kBinaryLevelExtension = ".glfb";
+
+struct SBinaryLevelHeader
+{
+	char magic[4]; // Always kBinaryLevelMagic
+	uint32_t version; // kBinaryLevelVersion when the file was written
+	uint32_t recordSize; // sizeof(SLevelObject) when the file was written
+	uint32_t reserved; // Keeps the records 8-byte aligned. Always 0.
+	uint64_t objectCount; // How many records follow the header
+};
+
+// A read-only view of a whole file, mapped into memory.
+class CMappedFile
+{
+private:
+	const unsigned char* data_ = nullptr; // Start of the mapping
+	size_t size_ = 0; // Size of the mapping in bytes
+#ifdef _WIN32
+	void* file_ = nullptr; // HANDLE to the file
+	void* mapping_ = nullptr; // HANDLE to the file mapping
+#endif
+
+public:
+	CMappedFile() = default;
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+	~CMappedFile();
+
+	// Map the file. Returns false if the file is missing or empty.
+	bool Open(const std::string& kFile);
+	// Unmap the file. The data can't be used afterwards.
+	void Close() noexcept;
+
+	const unsigned char* data() const noexcept
+	{
+		return data_;
+	}
+	size_t size() const noexcept
+	{
+		return size_;
+	}
+};
+
+// A read-only view of a memory-mapped binary level file.
+class CMappedLevel
+{
+private:
+	CMappedFile file_;
+	const SLevelObject* objects_ = nullptr; // First record, inside the mapping
+	size_t objectCount_ = 0;
+
+public:
+	// Map the file and check its header. Returns false if the file is missing, truncated or from another version.
+	bool Open(const std::string& kBinaryFile);
+	// Unmap the file. The records can't be used afterwards.
+	void Close() noexcept;
+
+	const SLevelObject* begin() const noexcept
+	{
+		return objects_;
+	}
+	const SLevelObject* end() const noexcept
+	{
+		return objects_ + objectCount_;
+	}
+	size_t size() const noexcept
+	{
+		return objectCount_;
+	}
+};
+
+// Get the binary file used to cache a level file, eg. level1.glf -> level1.glfb
+std::string GetBinaryLevelFile(const std::string& kLevelFile);
+// Check that the binary file exists and is not older than the level file it was built from.
+bool IsBinaryLevelCurrent(const std::string& kLevelFile, const std::string& kBinaryFile);
+// Write the objects to a binary level file. Returns false if the file can't be written.
+bool WriteBinaryLevel(const std::string& kBinaryFile, const SLevelObject* kFirst, const SLevelObject* kLast);
@@ -0,0 +1,93 @@
+#include "LevelColliders.h"
+#include <algorithm> // sort
+#include <cmath> // sinf, cosf
+#include <tuple> // tie, for sorting by several keys
+
+namespace
+{
+	// A box by its edges, which is easier to merge than a centre and half sizes.
+	struct SBoxEdges
+	{
+		float minX;
+		float maxX;
+		float minZ;
+		float maxZ;
+	};
+
+	// Merge the boxes that share the same x edges and touch along z.
+	// Called with the axes swapped to merge along x.
+	void MergeAlongZ(std::vector<SBoxEdges>& boxes, float SBoxEdges::* kMinX, float SBoxEdges::* kMaxX, float SBoxEdges::* kMinZ, float SBoxEdges::* kMaxZ)
+	{
+		if (boxes.empty())
+		{
+			return;
+		}
+		std::sort(boxes.begin(), boxes.end(), [&](const SBoxEdges& kBox1, const SBoxEdges& kBox2)
+		{
+			return std::tie(kBox1.*kMinX, kBox1.*kMaxX, kBox1.*kMinZ) < std::tie(kBox2.*kMinX, kBox2.*kMaxX, kBox2.*kMinZ);
+		});
+
+		size_t merged = 0;
+		for (size_t i = 1; i < boxes.size(); i++)
+		{
+			SBoxEdges& run = boxes[merged];
+			const SBoxEdges& kBox = boxes[i];
+			if (kBox.*kMinX == run.*kMinX && kBox.*kMaxX == run.*kMaxX && kBox.*kMinZ <= run.*kMaxZ + kColliderMergeGap)
+			{
+				run.*kMaxZ = std::max(run.*kMaxZ, kBox.*kMaxZ);
+			}
+			else
+			{
+				boxes[++merged] = kBox;
+			}
+		}
+		boxes.resize(merged + 1);
+	}
+}
+
+SBoxAxis GetLevelObjectAxis(const SLevelObject& kObject) noexcept
+{
+	const float kRotation = kObject.globalRotation[1];
+	if (IsRightAngleRotation(kRotation))
+	{
+		return { 1.0f, 0.0f };
+	}
+	// The engine turns a model's x axis to cos, -sin when it is rotated around y
+	constexpr float kRadiansPerDegree = 3.14159265358979f / 180.0f;
+	const float kAngle = kRotation * kRadiansPerDegree;
+	return { cosf(kAngle), -sinf(kAngle) };
+}
+
+std::vector<SBoxCollider> BuildBoxColliders(const SLevelObject* kFirst, const SLevelObject* kLast)
+{
+	std::vector<SBoxEdges> boxes;
+	std::vector<SBoxCollider> orientedBoxes;
+	for (const SLevelObject* kObject = kFirst; kObject != kLast; kObject++)
+	{
+		if (kObject->type == ELevelObjectType::objectIsleStraight || kObject->type == ELevelObjectType::objectWall)
+		{
+			const float kHalfWidth = kObject->width / 2.0f;
+			const float kHalfLength = kObject->length / 2.0f;
+			if (IsRightAngleRotation(kObject->globalRotation[1]))
+			{
+				boxes.push_back({ kObject->position[0] - kHalfWidth, kObject->position[0] + kHalfWidth, kObject->position[2] - kHalfLength, kObject->position[2] + kHalfLength });
+			}
+			else
+			{
+				orientedBoxes.push_back({ kObject->position[0], kObject->position[2], kHalfWidth, kHalfLength, GetLevelObjectAxis(*kObject) });
+			}
+		}
+	}
+
+	MergeAlongZ(boxes, &SBoxEdges::minX, &SBoxEdges::maxX, &SBoxEdges::minZ, &SBoxEdges::maxZ);
+	MergeAlongZ(boxes, &SBoxEdges::minZ, &SBoxEdges::maxZ, &SBoxEdges::minX, &SBoxEdges::maxX);
+
+	std::vector<SBoxCollider> colliders;
+	colliders.reserve(boxes.size() + orientedBoxes.size());
+	for (const SBoxEdges& kBox : boxes)
+	{
+		colliders.push_back({ (kBox.minX + kBox.maxX) / 2.0f, (kBox.minZ + kBox.maxZ) / 2.0f, (kBox.maxX - kBox.minX) / 2.0f, (kBox.maxZ - kBox.minZ) / 2.0f, { 1.0f, 0.0f } });
+	}
+	colliders.insert(colliders.end(), orientedBoxes.begin(), orientedBoxes.end());
+	return colliders;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector> // Vector class
+#include "Level.h" // SLevelObject
+
+// Collision shapes built from a level, separate from the models that draw it.
+// Isles and walls are laid end to end, so runs of touching pieces in a line are merged into one long box.
+// A merged run is tested once per frame instead of once per piece, and has no seams between pieces to catch on.
+// A merged run can be much longer than a grid square, so the collision grid lists it in every cell it covers.
+// Pieces turned by anything other than a right angle are oriented boxes. Their axis is worked out here, once, so
+// collision never needs sines or cosines. They are not merged.
+
+// A box on the ground, by its centre, half sizes and own x axis.
+struct SBoxCollider
+{
+	float x;
+	float z;
+	float halfWidth; // Half the size on the box's own x axis
+	float halfLength; // Half the size on the box's own z axis
+	SBoxAxis axis; // 1, 0 for an axis-aligned box
+};
+
+// Pieces closer than this are treated as touching.
+constexpr float kColliderMergeGap = 0.01f;
+
+// Get the direction of an object's own x axis on the ground, from its global y rotation.
+// An object turned by a right angle has its width and length swapped instead, so it stays axis aligned and gets 1, 0.
+SBoxAxis GetLevelObjectAxis(const SLevelObject& kObject) noexcept;
+
+// Build the box colliders for the isles and walls in a range of level objects, merging runs of touching, collinear boxes.
+// Other object types are skipped.
+std::vector<SBoxCollider> BuildBoxColliders(const SLevelObject* kFirst, const SLevelObject* kLast);
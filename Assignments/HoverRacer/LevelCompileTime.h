@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm> // min
+#include <array> // Fixed size array of level objects
+#include <cstddef> // size_t
+#include <string_view> // Level text without copying
+#include "Level.h" // SLevelObject
+
+// Compile-time level file (.glf) parser
+// Turns the text of a level embedded in the game into a constexpr array of level objects.
+// A malformed level throws during constant evaluation, which stops the build at the offending line of the parser.
+// Numbers may have a sign (+ or -) and decimals; exponents are not supported here.
+
+constexpr bool IsLevelWhitespace(const char& kCharacter) noexcept
+{
+	return kCharacter == ' ' || kCharacter == '\t' || kCharacter == '\r';
+}
+
+constexpr bool IsBlankLevelLine(const std::string_view& kLine) noexcept
+{
+	for (const char kCharacter : kLine)
+	{
+		if (!IsLevelWhitespace(kCharacter))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+// Count the objects (non-blank lines) in the text of a level.
+constexpr size_t CountLevelObjects(const std::string_view& kText) noexcept
+{
+	size_t objects = 0;
+	size_t lineBegin = 0;
+	while (lineBegin < kText.size())
+	{
+		const size_t kLineEnd = std::min(kText.find('\n', lineBegin), kText.size());
+		if (!IsBlankLevelLine(kText.substr(lineBegin, kLineEnd - lineBegin)))
+		{
+			objects++;
+		}
+		lineBegin = kLineEnd + 1;
+	}
+	return objects;
+}
+
+constexpr float ParseLevelNumber(const std::string_view& kItem)
+{
+	size_t index = 0;
+	const bool kNegative = (!kItem.empty() && kItem[0] == '-');
+	if (kNegative || (!kItem.empty() && kItem[0] == '+'))
+	{
+		index++;
+	}
+	double value = 0.0;
+	size_t digits = 0;
+	for (; index < kItem.size() && kItem[index] >= '0' && kItem[index] <= '9'; index++, digits++)
+	{
+		value = value * 10.0 + (kItem[index] - '0');
+	}
+	if (index < kItem.size() && kItem[index] == '.')
+	{
+		double place = 0.1;
+		for (index++; index < kItem.size() && kItem[index] >= '0' && kItem[index] <= '9'; index++, digits++)
+		{
+			value += (kItem[index] - '0') * place;
+			place /= 10.0;
+		}
+	}
+	if (digits == 0 || index != kItem.size())
+	{
+		throw "Embedded level: invalid number";
+	}
+	return static_cast<float>(kNegative ? -value : value);
+}
+
+// Parse one line of a level into an object.
+constexpr SLevelObject ParseLevelLine(const std::string_view& kLine)
+{
+	SLevelObject object{};
+	size_t current = 0;
+	for (unsigned int itemIndex = 0; itemIndex < EGameFileIndexes::fileIndexesTotal; itemIndex++)
+	{
+		while (current < kLine.size() && IsLevelWhitespace(kLine[current]))
+		{
+			current++;
+		}
+		size_t itemEnd = current;
+		while (itemEnd < kLine.size() && !IsLevelWhitespace(kLine[itemEnd]))
+		{
+			itemEnd++;
+		}
+		if (itemEnd == current)
+		{
+			throw "Embedded level: missing item";
+		}
+
+		const std::string_view kItem = kLine.substr(current, itemEnd - current);
+		switch (itemIndex)
+		{
+		case EGameFileIndexes::objectIndex:
+		{
+			if (!GetLevelObjectType(kItem, object.type))
+			{
+				throw "Embedded level: unknown object type";
+			}
+			break;
+		}
+		case EGameFileIndexes::xPosIndex:
+		case EGameFileIndexes::yPosIndex:
+		case EGameFileIndexes::zPosIndex:
+		{
+			object.position[itemIndex - EGameFileIndexes::xPosIndex] = ParseLevelNumber(kItem);
+			break;
+		}
+		case EGameFileIndexes::globalXRotationIndex:
+		case EGameFileIndexes::globalYRotationIndex:
+		case EGameFileIndexes::globalZRotationIndex:
+		{
+			object.globalRotation[itemIndex - EGameFileIndexes::globalXRotationIndex] = ParseLevelNumber(kItem);
+			break;
+		}
+		case EGameFileIndexes::localXRotationIndex:
+		case EGameFileIndexes::localYRotationIndex:
+		case EGameFileIndexes::localZRotationIndex:
+		{
+			object.localRotation[itemIndex - EGameFileIndexes::localXRotationIndex] = ParseLevelNumber(kItem);
+			break;
+		}
+		default:
+		{
+			object.scale = ParseLevelNumber(kItem);
+			break;
+		}
+		}
+		current = itemEnd;
+	}
+
+	if (!IsBlankLevelLine(kLine.substr(current)))
+	{
+		throw "Embedded level: too many items";
+	}
+	SetLevelObjectExtents(object);
+	return object;
+}
+
+// Parse the text of a level. kObjectCount must be CountLevelObjects(kText).
+template <size_t kObjectCount>
+constexpr std::array<SLevelObject, kObjectCount> ParseEmbeddedLevel(const std::string_view& kText)
+{
+	std::array<SLevelObject, kObjectCount> objects{};
+	size_t nextObject = 0;
+	size_t lineBegin = 0;
+	while (lineBegin < kText.size())
+	{
+		const size_t kLineEnd = std::min(kText.find('\n', lineBegin), kText.size());
+		const std::string_view kLine = kText.substr(lineBegin, kLineEnd - lineBegin);
+		if (!IsBlankLevelLine(kLine))
+		{
+			objects[nextObject++] = ParseLevelLine(kLine);
+		}
+		lineBegin = kLineEnd + 1;
+	}
+	return objects;
+}
@@ -0,0 +1,165 @@
+#include "LevelLoader.h"
+#include <algorithm> // count_if
+#include <chrono> // Polling the worker without waiting
+#include <filesystem> // Level file sizes
+#include <fstream> // Comparing a level file with its embedded copy
+#include <iterator> // istreambuf_iterator
+#include "EmbeddedLevels.h" // Shipped levels parsed at compile time
+#include "LevelBake.h" // Levels checked and prepared by the level baker
+#include "LevelBinary.h" // Precompiled, memory-mapped level files
+
+bool PrepareLevel(const SLevelObject* kFirst, const SLevelObject* kLast, SLoadedLevel& level)
+{
+	// Split the objects into the ones the race needs and the streamed scenery.
+	std::vector<SLevelObject> scenery;
+	size_t checkpoints = 0;
+	for (const SLevelObject* kObject = kFirst; kObject != kLast; kObject++)
+	{
+		switch (kObject->type)
+		{
+		case ELevelObjectType::objectCheckpoint:
+		case ELevelObjectType::objectWaypoint:
+		{
+			SRaceObject raceObject{ *kObject, GetGridIndex(kObject->position[0]), GetGridIndex(kObject->position[2]), GetLevelObjectAxis(*kObject), {} };
+			if (kObject->type == ELevelObjectType::objectCheckpoint)
+			{
+				raceObject.struts = GetCheckpointStruts(*kObject, raceObject.axis);
+				checkpoints++;
+			}
+			level.raceObjects.push_back(raceObject);
+			break;
+		}
+		case ELevelObjectType::objectIsleStraight:
+		case ELevelObjectType::objectWall:
+		case ELevelObjectType::objectWaterTank:
+			scenery.push_back(*kObject);
+			break;
+		default:
+			// Only a damaged binary file can get here, so there is no column to report.
+			level.error = { static_cast<unsigned int>(kObject - kFirst) + 1, 0, "Unknown object type" };
+			return false;
+		}
+	}
+	// The race is run from checkpoint to checkpoint, and the enemy follows the waypoints.
+	if (checkpoints == 0 || checkpoints == level.raceObjects.size())
+	{
+		level.error = { 0, 0, "A level needs at least one checkpoint and one waypoint" };
+		return false;
+	}
+
+	level.scenery.Assign(scenery.data(), scenery.data() + scenery.size());
+	level.boxColliders = BuildBoxColliders(scenery.data(), scenery.data() + scenery.size());
+	level.boxPieces = static_cast<size_t>(std::count_if(scenery.begin(), scenery.end(), [](const SLevelObject& kObject)
+	{
+		return kObject.type != ELevelObjectType::objectWaterTank;
+	}));
+	return true;
+}
+
+namespace
+{
+	// The embedded copy of a level can be used if its file is missing or still holds the text that was embedded.
+	bool IsEmbeddedLevelCurrent(const std::string& kLevelFile, const SEmbeddedLevel& kLevel)
+	{
+		std::error_code error;
+		const bool kFileExists = std::filesystem::exists(kLevelFile, error);
+		if (error)
+		{
+			return false;
+		}
+		if (!kFileExists)
+		{
+			return true;
+		}
+		// Most edits change the size, which saves reading the file.
+		const auto kFileSize = std::filesystem::file_size(kLevelFile, error);
+		if (error || kFileSize != kLevel.text.size())
+		{
+			return false;
+		}
+		std::ifstream inputStream(kLevelFile, std::ios::binary);
+		const std::string kText{ std::istreambuf_iterator<char>(inputStream), std::istreambuf_iterator<char>() };
+		return kText == kLevel.text;
+	}
+}
+
+SLoadedLevel LoadLevel(const std::string& kLevelFile)
+{
+	SLoadedLevel level;
+	level.levelFile = kLevelFile;
+
+	// A baked level has been checked and prepared by the level baker, so it is used as it is.
+	const std::string kBakedFile = GetBakedLevelFile(kLevelFile);
+	if (IsBinaryLevelCurrent(kLevelFile, kBakedFile) && ReadBakedLevel(kBakedFile, level))
+	{
+		level.source = kBakedFile;
+		level.succeeded = true;
+		return level;
+	}
+
+	// Shipped levels are parsed at compile time, so there is nothing to read unless the file has been edited since.
+	const SEmbeddedLevel* kEmbeddedLevel = FindEmbeddedLevel(kLevelFile);
+	if (kEmbeddedLevel != nullptr && IsEmbeddedLevelCurrent(kLevelFile, *kEmbeddedLevel))
+	{
+		level.source = "embedded level";
+		level.succeeded = PrepareLevel(kEmbeddedLevel->objects, kEmbeddedLevel->objects + kEmbeddedLevel->objectCount, level);
+		return level;
+	}
+
+	const std::string kBinaryFile = GetBinaryLevelFile(kLevelFile);
+	CMappedLevel mappedLevel;
+	if (IsBinaryLevelCurrent(kLevelFile, kBinaryFile) && mappedLevel.Open(kBinaryFile))
+	{
+		level.source = kBinaryFile;
+		level.succeeded = PrepareLevel(mappedLevel.begin(), mappedLevel.end(), level);
+		return level;
+	}
+
+	std::vector<SLevelObject> levelObjects;
+	level.source = kLevelFile;
+	if (!ReadLevelFile(kLevelFile, levelObjects, level.error))
+	{
+		return level;
+	}
+	// A missing binary copy only makes the next load slower, so failing to write one is not an error.
+	if (!WriteBinaryLevel(kBinaryFile, levelObjects.data(), levelObjects.data() + levelObjects.size()))
+	{
+		level.warning = "Could not write the binary level file: " + kBinaryFile;
+	}
+	level.succeeded = PrepareLevel(levelObjects.data(), levelObjects.data() + levelObjects.size(), level);
+	return level;
+}
+
+SLoadedLevel ReloadLevel(const std::string& kLevelFile)
+{
+	SLoadedLevel level;
+	level.levelFile = kLevelFile;
+	level.source = kLevelFile;
+	std::vector<SLevelObject> levelObjects;
+	if (ReadLevelFile(kLevelFile, levelObjects, level.error))
+	{
+		level.succeeded = PrepareLevel(levelObjects.data(), levelObjects.data() + levelObjects.size(), level);
+	}
+	return level;
+}
+
+bool CLevelLoader::Start(const std::string& kLevelFile)
+{
+	if (level_.valid())
+	{
+		return levelFile_ == kLevelFile;
+	}
+	levelFile_ = kLevelFile;
+	level_ = std::async(std::launch::async, LoadLevel, kLevelFile);
+	return true;
+}
+
+bool CLevelLoader::IsReady() const
+{
+	return level_.valid() && level_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+SLoadedLevel CLevelLoader::Take()
+{
+	return level_.get();
+}
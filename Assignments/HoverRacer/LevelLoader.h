@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint> // Fixed width integers for baked records
+#include <future> // Result of the worker thread
+#include <string> // String class
+#include <vector> // Vector class
+#include "Level.h" // SLevelObject
+#include "LevelColliders.h" // Merged box colliders
+#include "LevelParser.h" // SLevelParseError
+#include "LevelSectors.h" // Scenery grouped by grid square
+
+// Background level loading
+// Reading, parsing and sorting a level into sectors happens on a worker thread while the game keeps drawing frames.
+// The engine is not thread safe, so the models are created from the finished level on the main thread, a few per frame.
+
+// A checkpoint or waypoint, with its grid square, axis and struts worked out when the level is prepared.
+struct SRaceObject
+{
+	SLevelObject object;
+	int32_t gridX;
+	int32_t gridZ;
+	SBoxAxis axis; // From GetLevelObjectAxis
+	SCheckpointStruts struts; // Checkpoints only
+};
+
+// A level that has been read and prepared, ready for its models to be created.
+struct SLoadedLevel
+{
+	std::string levelFile;
+	std::string source; // Where the objects came from: the embedded copy, the binary copy or the text file
+	bool succeeded = false;
+	SLevelParseError error; // Why the level could not be loaded
+	std::string warning; // A problem that did not stop the level loading. Empty if there was none.
+	std::vector<SRaceObject> raceObjects; // Checkpoints and waypoints, in level order
+	CLevelSectors scenery; // Isles, walls and water tanks
+	std::vector<SBoxCollider> boxColliders; // Isles and walls, with runs of touching pieces merged
+	size_t boxPieces = 0; // How many isles and walls the colliders were built from
+};
+
+// Sort the objects of a level and work out everything the game needs from them: grid squares, struts, scenery sectors and merged colliders.
+// Returns false and fills level.error if the level can't be raced, eg. it has an unknown object or no checkpoints.
+bool PrepareLevel(const SLevelObject* kFirst, const SLevelObject* kLast, SLoadedLevel& level);
+
+// Load a level on the calling thread.
+// Uses the baked copy of the level when it is up to date, then the copy embedded in the game for a shipped level whose file has not been edited, then the precompiled binary copy of the level when it is up to date, otherwise reads the text file and rebuilds the binary copy.
+SLoadedLevel LoadLevel(const std::string& kLevelFile);
+
+// Read a level from its text file, skipping the embedded and binary copies.
+// Used to pick up edits to a level while the game is running.
+SLoadedLevel ReloadLevel(const std::string& kLevelFile);
+
+// Loads one level at a time on a worker thread.
+class CLevelLoader
+{
+private:
+	std::future<SLoadedLevel> level_;
+	std::string levelFile_;
+
+public:
+	// Start loading a level. Returns true if the level is now being loaded, including when it already was.
+	// Returns false, and leaves the loader alone, if a different level is being loaded.
+	bool Start(const std::string& kLevelFile);
+	// Has a level been started and not yet taken?
+	bool IsStarted() const noexcept
+	{
+		return level_.valid();
+	}
+	const std::string& GetLevelFile() const noexcept
+	{
+		return levelFile_;
+	}
+	// Has the worker finished loading? Never waits.
+	bool IsReady() const;
+	// Get the loaded level, waiting for the worker if it has not finished yet.
+	SLoadedLevel Take();
+};
@@ -0,0 +1,245 @@
+#include "LevelParser.h"
+#include <algorithm> // min
+#include <charconv> // from_chars
+#include <fstream> // File input
+#include <string_view> // Item names without copying
+#include <thread> // Parsing chunks of lines in parallel
+
+namespace
+{
+	// Below this many lines per thread, starting a thread costs more than it saves.
+	constexpr size_t kMinLinesPerThread = 4096;
+
+	// The position of a single non-blank line in the file text
+	struct SLevelLine
+	{
+		const char* begin;
+		const char* end;
+		unsigned int number; // Line number in the file, starting at 1
+	};
+
+	bool IsWhitespace(const char& kCharacter) noexcept
+	{
+		return kCharacter == ' ' || kCharacter == '\t' || kCharacter == '\r';
+	}
+
+	const char* SkipWhitespace(const char* current, const char* kEnd) noexcept
+	{
+		while (current != kEnd && IsWhitespace(*current))
+		{
+			current++;
+		}
+		return current;
+	}
+
+	const char* FindWhitespace(const char* current, const char* kEnd) noexcept
+	{
+		while (current != kEnd && !IsWhitespace(*current))
+		{
+			current++;
+		}
+		return current;
+	}
+
+	// Most items in a level are small whole numbers. Read those directly and leave anything else to from_chars.
+	bool ParseWholeNumber(const char* current, const char* kEnd, float& value) noexcept
+	{
+		// Whole numbers with up to 7 digits are exact as a float.
+		constexpr ptrdiff_t kMaxDigits = 7;
+		const bool kNegative = (current != kEnd && *current == '-');
+		if (kNegative)
+		{
+			current++;
+		}
+		if (current == kEnd || kEnd - current > kMaxDigits)
+		{
+			return false;
+		}
+		int number = 0;
+		for (; current != kEnd; current++)
+		{
+			if (*current < '0' || *current > '9')
+			{
+				return false;
+			}
+			number = number * 10 + (*current - '0');
+		}
+		value = static_cast<float>(kNegative ? -number : number);
+		return true;
+	}
+
+	bool ParseNumber(const char* kBegin, const char* kEnd, float& value) noexcept
+	{
+		// stoi took a leading '+' and level files written for it may have one, but from_chars does not.
+		if (kBegin != kEnd && *kBegin == '+')
+		{
+			kBegin++;
+			if (kBegin != kEnd && *kBegin == '-')
+			{
+				return false;
+			}
+		}
+		if (ParseWholeNumber(kBegin, kEnd, value))
+		{
+			return true;
+		}
+		const std::from_chars_result kResult = std::from_chars(kBegin, kEnd, value);
+		return kResult.ec == std::errc() && kResult.ptr == kEnd;
+	}
+
+	// The field of a level object that each item on a line is stored in.
+	float* GetNumericField(SLevelObject& object, const unsigned int& kItemIndex) noexcept
+	{
+		switch (kItemIndex)
+		{
+		case EGameFileIndexes::xPosIndex:
+		case EGameFileIndexes::yPosIndex:
+		case EGameFileIndexes::zPosIndex:
+			return &object.position[kItemIndex - EGameFileIndexes::xPosIndex];
+		case EGameFileIndexes::globalXRotationIndex:
+		case EGameFileIndexes::globalYRotationIndex:
+		case EGameFileIndexes::globalZRotationIndex:
+			return &object.globalRotation[kItemIndex - EGameFileIndexes::globalXRotationIndex];
+		case EGameFileIndexes::localXRotationIndex:
+		case EGameFileIndexes::localYRotationIndex:
+		case EGameFileIndexes::localZRotationIndex:
+			return &object.localRotation[kItemIndex - EGameFileIndexes::localXRotationIndex];
+		case EGameFileIndexes::scaleIndex:
+			return &object.scale;
+		default:
+			return nullptr;
+		}
+	}
+
+	bool SetError(SLevelParseError& error, const SLevelLine& kLine, const char* kPosition, const char* kMessage)
+	{
+		error.line = kLine.number;
+		error.column = static_cast<unsigned int>(kPosition - kLine.begin) + 1;
+		error.message = kMessage;
+		return false;
+	}
+
+	// Parse one line into a level object
+	bool ParseLevelLine(const SLevelLine& kLine, SLevelObject& object, SLevelParseError& error)
+	{
+		object = {};
+		const char* current = kLine.begin;
+		for (unsigned int itemIndex = 0; itemIndex < EGameFileIndexes::fileIndexesTotal; itemIndex++)
+		{
+			current = SkipWhitespace(current, kLine.end);
+			const char* kItemEnd = FindWhitespace(current, kLine.end);
+			if (current == kItemEnd)
+			{
+				return SetError(error, kLine, current, "Missing item");
+			}
+
+			if (itemIndex == EGameFileIndexes::objectIndex)
+			{
+				if (!GetLevelObjectType(std::string_view(current, kItemEnd - current), object.type))
+				{
+					return SetError(error, kLine, current, "Unknown object type");
+				}
+			}
+			else
+			{
+				if (!ParseNumber(current, kItemEnd, *GetNumericField(object, itemIndex)))
+				{
+					return SetError(error, kLine, current, "Invalid number");
+				}
+			}
+			current = kItemEnd;
+		}
+
+		current = SkipWhitespace(current, kLine.end);
+		if (current != kLine.end)
+		{
+			return SetError(error, kLine, current, "Too many items");
+		}
+		SetLevelObjectExtents(object);
+		return true;
+	}
+
+	// Parse a chunk of lines. Stops at the first malformed line.
+	bool ParseLevelLines(const SLevelLine* kFirst, const SLevelLine* kLast, SLevelObject* objects, SLevelParseError& error)
+	{
+		for (const SLevelLine* kLine = kFirst; kLine != kLast; kLine++, objects++)
+		{
+			if (!ParseLevelLine(*kLine, *objects, error))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool ParseLevelText(const char* kText, const size_t& kSize, std::vector<SLevelObject>& objects, SLevelParseError& error)
+{
+	// Split the text into non-blank lines.
+	std::vector<SLevelLine> lines;
+	const char* kEnd = kText + kSize;
+	unsigned int lineNumber = 1;
+	for (const char* lineBegin = kText; lineBegin < kEnd; lineNumber++)
+	{
+		const char* lineEnd = std::find(lineBegin, kEnd, '\n');
+		if (SkipWhitespace(lineBegin, lineEnd) != lineEnd)
+		{
+			lines.push_back({ lineBegin, lineEnd, lineNumber });
+		}
+		lineBegin = lineEnd + 1;
+	}
+
+	objects.resize(lines.size());
+	const size_t kThreads = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()), lines.size() / kMinLinesPerThread);
+	if (kThreads <= 1)
+	{
+		return ParseLevelLines(lines.data(), lines.data() + lines.size(), objects.data(), error);
+	}
+
+	// Give each thread an equal chunk of lines, and keep the error from the earliest line.
+	std::vector<std::thread> workers;
+	std::vector<SLevelParseError> errors(kThreads);
+	std::vector<char> succeeded(kThreads, true);
+	const size_t kLinesPerThread = (lines.size() + kThreads - 1) / kThreads;
+	for (size_t i = 0; i < kThreads; i++)
+	{
+		const size_t kFirst = std::min(lines.size(), i * kLinesPerThread);
+		const size_t kLast = std::min(lines.size(), kFirst + kLinesPerThread);
+		workers.emplace_back([&, i, kFirst, kLast]()
+		{
+			succeeded[i] = ParseLevelLines(lines.data() + kFirst, lines.data() + kLast, objects.data() + kFirst, errors[i]);
+		});
+	}
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	for (size_t i = 0; i < kThreads; i++)
+	{
+		if (!succeeded[i])
+		{
+			error = errors[i];
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ReadLevelFile(const std::string& kLevelFile, std::vector<SLevelObject>& objects, SLevelParseError& error)
+{
+	// Read the whole file in one go.
+	std::ifstream inputStream(kLevelFile, std::ios::binary | std::ios::ate);
+	if (!inputStream)
+	{
+		error = { 0, 0, "File cannot be accessed/does not exist" };
+		return false;
+	}
+	std::string text(static_cast<size_t>(inputStream.tellg()), '\0');
+	inputStream.seekg(0);
+	if (!inputStream.read(text.data(), static_cast<std::streamsize>(text.size())))
+	{
+		error = { 0, 0, "File cannot be read" };
+		return false;
+	}
+	return ParseLevelText(text.data(), text.size(), objects, error);
+}
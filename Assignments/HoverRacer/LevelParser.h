@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef> // size_t
+#include <string> // String class
+#include <vector> // Vector class
+#include "Level.h" // SLevelObject
+
+// Text level file (.glf) parser
+// The whole file is read once and split into line ranges. Lines are parsed in place with std::from_chars,
+// without creating a string per item, and large files are parsed in chunks on every core.
+
+// Where and why parsing a level failed. Line and column start at 1; line 0 means the file itself could not be read.
+struct SLevelParseError
+{
+	unsigned int line = 0;
+	unsigned int column = 0;
+	std::string message;
+};
+
+// Parse the text of a level file. Objects are returned in file order; blank lines are skipped.
+// Returns false and fills error with the first malformed line if the text is not a valid level.
+bool ParseLevelText(const char* kText, const size_t& kSize, std::vector<SLevelObject>& objects, SLevelParseError& error);
+// Read and parse a level file.
+bool ReadLevelFile(const std::string& kLevelFile, std::vector<SLevelObject>& objects, SLevelParseError& error);
@@ -0,0 +1,109 @@
+#include "LevelSectors.h"
+#include <algorithm> // sort
+
+void CLevelSectors::Assign(const SLevelObject* kFirst, const SLevelObject* kLast)
+{
+	Clear();
+	const size_t kObjectCount = static_cast<size_t>(kLast - kFirst);
+
+	// Count the objects in each sector, then give each sector its own range.
+	std::vector<uint64_t> keys(kObjectCount);
+	for (size_t i = 0; i < kObjectCount; i++)
+	{
+		keys[i] = GetSectorKey(GetGridIndex(kFirst[i].position[0]), GetGridIndex(kFirst[i].position[2]));
+		sectors_[keys[i]].count++;
+	}
+	size_t nextFirst = 0;
+	for (auto& sector : sectors_)
+	{
+		sector.second.first = nextFirst;
+		nextFirst += sector.second.count;
+		sector.second.count = 0;
+	}
+
+	// Copy each object to the end of its sector's range, which keeps the level order within a sector.
+	objects_.resize(kObjectCount);
+	for (size_t i = 0; i < kObjectCount; i++)
+	{
+		SSectorRange& range = sectors_[keys[i]];
+		objects_[range.first + range.count] = kFirst[i];
+		range.count++;
+	}
+}
+
+bool CLevelSectors::AssignGrouped(const SLevelObject* kObjects, const size_t& kObjectCount, const SLevelSector* kFirst, const SLevelSector* kLast)
+{
+	Clear();
+	for (const SLevelSector* kSector = kFirst; kSector != kLast; kSector++)
+	{
+		if (kSector->first > kObjectCount || kSector->count > kObjectCount - kSector->first)
+		{
+			Clear();
+			return false;
+		}
+		sectors_[kSector->key] = { static_cast<size_t>(kSector->first), static_cast<size_t>(kSector->count) };
+	}
+	objects_.assign(kObjects, kObjects + kObjectCount);
+	return true;
+}
+
+void CLevelSectors::Clear() noexcept
+{
+	objects_.clear();
+	sectors_.clear();
+}
+
+const SLevelObject* CLevelSectors::GetSector(const int& kGridX, const int& kGridZ, size_t& count) const noexcept
+{
+	const auto kSector = sectors_.find(GetSectorKey(kGridX, kGridZ));
+	if (kSector == sectors_.end())
+	{
+		count = 0;
+		return nullptr;
+	}
+	count = kSector->second.count;
+	return objects_.data() + kSector->second.first;
+}
+
+std::vector<uint64_t> CLevelSectors::GetChangedSectors(const CLevelSectors& kOther) const
+{
+	std::vector<uint64_t> changed;
+	for (const auto& kSector : sectors_)
+	{
+		size_t otherCount = 0;
+		const SLevelObject* kOtherObjects = kOther.GetSector(GetSectorGridX(kSector.first), GetSectorGridZ(kSector.first), otherCount);
+		bool isSame = (otherCount == kSector.second.count);
+		for (size_t i = 0; isSame && i < otherCount; i++)
+		{
+			isSame = IsSameLevelObject(objects_[kSector.second.first + i], kOtherObjects[i]);
+		}
+		if (!isSame)
+		{
+			changed.push_back(kSector.first);
+		}
+	}
+	for (const auto& kSector : kOther.sectors_)
+	{
+		if (sectors_.count(kSector.first) == 0)
+		{
+			changed.push_back(kSector.first);
+		}
+	}
+	return changed;
+}
+
+std::vector<SLevelSector> CLevelSectors::GetSectors() const
+{
+	std::vector<SLevelSector> sectors;
+	sectors.reserve(sectors_.size());
+	for (const auto& kSector : sectors_)
+	{
+		sectors.push_back({ kSector.first, kSector.second.first, kSector.second.count });
+	}
+	// The map has no order of its own, so sort to keep baked files the same from run to run.
+	std::sort(sectors.begin(), sectors.end(), [](const SLevelSector& kSector1, const SLevelSector& kSector2)
+	{
+		return kSector1.key < kSector2.key;
+	});
+	return sectors;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for sector keys
+#include <unordered_map> // Sector lookup
+#include <vector> // Vector class
+#include "Level.h" // SLevelObject, GetGridIndex
+
+// Level objects grouped into sectors, one per square of the kGridSize grid.
+// Used to stream scenery in and out around the player, so only the sectors close by need models.
+// The objects of each sector are stored next to each other, in the order they appear in the level.
+
+// Pack the grid coordinates of a sector into one key.
+constexpr uint64_t GetSectorKey(const int& kGridX, const int& kGridZ) noexcept
+{
+	return (static_cast<uint64_t>(static_cast<uint32_t>(kGridX)) << 32) | static_cast<uint32_t>(kGridZ);
+}
+constexpr int GetSectorGridX(const uint64_t& kKey) noexcept
+{
+	return static_cast<int>(static_cast<uint32_t>(kKey >> 32));
+}
+constexpr int GetSectorGridZ(const uint64_t& kKey) noexcept
+{
+	return static_cast<int>(static_cast<uint32_t>(kKey));
+}
+
+// The objects of one sector, as a range of the objects grouped by sector.
+struct SLevelSector
+{
+	uint64_t key; // GetSectorKey of the sector's grid square
+	uint64_t first;
+	uint64_t count;
+};
+
+class CLevelSectors
+{
+private:
+	// Where the objects of one sector are in objects_
+	struct SSectorRange
+	{
+		size_t first;
+		size_t count;
+	};
+
+	std::vector<SLevelObject> objects_; // Grouped by sector
+	std::unordered_map<uint64_t, SSectorRange> sectors_;
+
+public:
+	// Replace the stored objects with a copy of a range of level objects.
+	void Assign(const SLevelObject* kFirst, const SLevelObject* kLast);
+	// Replace the stored objects with a copy of objects that are already grouped into sectors, eg. from a baked level.
+	// Returns false, and stores nothing, if a sector's range is outside the objects.
+	bool AssignGrouped(const SLevelObject* kObjects, const size_t& kObjectCount, const SLevelSector* kFirst, const SLevelSector* kLast);
+	void Clear() noexcept;
+
+	// Get every sector, sorted by key, with the range of its objects in GetObjects.
+	std::vector<SLevelSector> GetSectors() const;
+	// Get the objects of every sector, grouped by sector.
+	const SLevelObject* GetObjects() const noexcept
+	{
+		return objects_.data();
+	}
+
+	// Get the keys of the sectors whose objects are not the same in both, including sectors only one of them has.
+	std::vector<uint64_t> GetChangedSectors(const CLevelSectors& kOther) const;
+
+	// Get the objects in a sector. Returns nullptr and a count of 0 if the sector is empty.
+	const SLevelObject* GetSector(const int& kGridX, const int& kGridZ, size_t& count) const noexcept;
+	size_t GetObjectCount() const noexcept
+	{
+		return objects_.size();
+	}
+	size_t GetSectorCount() const noexcept
+	{
+		return sectors_.size();
+	}
+};
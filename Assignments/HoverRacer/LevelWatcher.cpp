@@ -0,0 +1,136 @@
+#include "LevelWatcher.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h> // FindFirstChangeNotification
+#else
+#include <cstring> // strcmp
+#include <limits.h> // NAME_MAX
+#include <sys/inotify.h> // inotify
+#include <unistd.h> // read, close
+#endif
+
+namespace
+{
+	// The folder a file is in, or "." if the path has no folder.
+	std::string GetFolder(const std::string& kFile)
+	{
+		const size_t kFolderEnd = kFile.find_last_of("/\\");
+		return (kFolderEnd == std::string::npos) ? "." : kFile.substr(0, kFolderEnd);
+	}
+}
+
+CLevelWatcher::~CLevelWatcher()
+{
+	Stop();
+}
+
+#ifdef _WIN32
+
+bool CLevelWatcher::Watch(const std::string& kLevelFile)
+{
+	Stop();
+	std::error_code error;
+	lastWrite_ = std::filesystem::last_write_time(kLevelFile, error);
+	if (error)
+	{
+		return false;
+	}
+	HANDLE notification = FindFirstChangeNotificationA(GetFolder(kLevelFile).c_str(), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+	if (notification == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	notification_ = notification;
+	levelFile_ = kLevelFile;
+	return true;
+}
+
+void CLevelWatcher::Stop() noexcept
+{
+	if (notification_ != nullptr)
+	{
+		FindCloseChangeNotification(notification_);
+		notification_ = nullptr;
+	}
+	levelFile_.clear();
+}
+
+bool CLevelWatcher::HasChanged()
+{
+	if (notification_ == nullptr || WaitForSingleObject(notification_, 0) != WAIT_OBJECT_0)
+	{
+		return false;
+	}
+	FindNextChangeNotification(notification_);
+
+	// The notification is for the whole folder, so check the level file itself was written.
+	std::error_code error;
+	const std::filesystem::file_time_type kLastWrite = std::filesystem::last_write_time(levelFile_, error);
+	if (error || kLastWrite == lastWrite_)
+	{
+		return false;
+	}
+	lastWrite_ = kLastWrite;
+	return true;
+}
+
+#else
+
+bool CLevelWatcher::Watch(const std::string& kLevelFile)
+{
+	Stop();
+	inotify_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_ < 0)
+	{
+		return false;
+	}
+	if (inotify_add_watch(inotify_, GetFolder(kLevelFile).c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+	{
+		Stop();
+		return false;
+	}
+	const size_t kFolderEnd = kLevelFile.find_last_of('/');
+	fileName_ = (kFolderEnd == std::string::npos) ? kLevelFile : kLevelFile.substr(kFolderEnd + 1);
+	levelFile_ = kLevelFile;
+	return true;
+}
+
+void CLevelWatcher::Stop() noexcept
+{
+	if (inotify_ >= 0)
+	{
+		close(inotify_);
+		inotify_ = -1;
+	}
+	levelFile_.clear();
+	fileName_.clear();
+}
+
+bool CLevelWatcher::HasChanged()
+{
+	if (inotify_ < 0)
+	{
+		return false;
+	}
+
+	// Drain every waiting event, so a save that produces several events is reported once.
+	bool changed = false;
+	alignas(inotify_event) char buffer[16 * (sizeof(inotify_event) + NAME_MAX + 1)];
+	ssize_t length = 0;
+	while ((length = read(inotify_, buffer, sizeof(buffer))) > 0)
+	{
+		for (const char* current = buffer; current < buffer + length;)
+		{
+			const inotify_event* kEvent = reinterpret_cast<const inotify_event*>(current);
+			if (kEvent->len > 0 && strcmp(kEvent->name, fileName_.c_str()) == 0)
+			{
+				changed = true;
+			}
+			current += sizeof(inotify_event) + kEvent->len;
+		}
+	}
+	return changed;
+}
+
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <string> // String class
+#ifdef _WIN32
+#include <filesystem> // Last write time of the level file
+#endif
+
+// Watches a level file for edits, so a track can be tuned while the game is running.
+// Uses inotify on Linux and a change notification on the level's folder on Windows. Checking never blocks.
+// Editors often save by writing a new file and renaming it over the old one, so the folder is watched rather than the file.
+
+class CLevelWatcher
+{
+private:
+	std::string levelFile_;
+#ifdef _WIN32
+	void* notification_ = nullptr; // HANDLE from FindFirstChangeNotification
+	std::filesystem::file_time_type lastWrite_;
+#else
+	int inotify_ = -1; // inotify instance
+	std::string fileName_; // The level file's name without its folder, as inotify reports it
+#endif
+
+public:
+	CLevelWatcher() = default;
+	CLevelWatcher(const CLevelWatcher&) = delete;
+	CLevelWatcher& operator=(const CLevelWatcher&) = delete;
+	~CLevelWatcher();
+
+	// Start watching a level file, and stop watching the previous one. Returns false if the file can't be watched.
+	bool Watch(const std::string& kLevelFile);
+	void Stop() noexcept;
+	// Has the level file been saved since the last check?
+	bool HasChanged();
+	const std::string& GetLevelFile() const noexcept
+	{
+		return levelFile_;
+	}
+};
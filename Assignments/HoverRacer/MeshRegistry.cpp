@@ -0,0 +1,66 @@
+#include "MeshRegistry.h"
+#include <chrono> // Timing mesh loads
+#include <filesystem> // Mesh file sizes
+#include <iomanip> // Report columns
+
+void CMeshRegistry::AddMediaFolder(const std::string& kFolder)
+{
+	folders_.push_back(kFolder);
+	engine_->AddMediaFolder(kFolder);
+}
+
+tle::IMesh* CMeshRegistry::Get(const std::string& kFile)
+{
+	const auto kExisting = meshes_.find(kFile);
+	if (kExisting != meshes_.end())
+	{
+		return kExisting->second.mesh;
+	}
+
+	SMeshInfo info;
+	const auto kStart = std::chrono::steady_clock::now();
+	info.mesh = engine_->LoadMesh(kFile);
+	info.loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - kStart).count();
+	for (const std::string& kFolder : folders_)
+	{
+		std::error_code error;
+		const uintmax_t kBytes = std::filesystem::file_size(std::filesystem::path(kFolder) / kFile, error);
+		if (!error)
+		{
+			info.fileBytes = kBytes;
+			break;
+		}
+	}
+
+	meshes_.emplace(kFile, info);
+	loadOrder_.push_back(kFile);
+	return info.mesh;
+}
+
+void CMeshRegistry::PrintReport(std::ostream& output) const
+{
+	constexpr double kMilliseconds = 1000.0;
+	constexpr double kKilobytes = 1024.0;
+	double totalSeconds = 0.0;
+	uintmax_t totalBytes = 0;
+
+	output << std::left << std::setw(20) << "Mesh" << std::right << std::setw(12) << "Load (ms)" << std::setw(12) << "File (KB)" << "\n";
+	output << std::fixed << std::setprecision(2);
+	for (const std::string& kFile : loadOrder_)
+	{
+		const SMeshInfo& kInfo = meshes_.at(kFile);
+		output << std::left << std::setw(20) << kFile << std::right << std::setw(12) << kInfo.loadSeconds * kMilliseconds;
+		if (kInfo.fileBytes == 0)
+		{
+			output << std::setw(12) << "?" << "\n";
+		}
+		else
+		{
+			output << std::setw(12) << kInfo.fileBytes / kKilobytes << "\n";
+		}
+		totalSeconds += kInfo.loadSeconds;
+		totalBytes += kInfo.fileBytes;
+	}
+	output << "Total: " << loadOrder_.size() << " meshes, " << totalSeconds * kMilliseconds << " ms, " << totalBytes / kKilobytes << " KB" << std::endl;
+	output << std::defaultfloat;
+}
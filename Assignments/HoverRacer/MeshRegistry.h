@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // uintmax_t
+#include <ostream> // Report output
+#include <string> // String class
+#include <unordered_map> // Meshes by file name
+#include <vector> // Vector class
+#include <TL-Engine.h> // IMesh, I3DEngine
+
+// Mesh registry
+// Every mesh in the game is loaded through here, by file name. A mesh is loaded the first time something asks for it
+// and shared after that, so the work done at startup depends on what the level uses rather than on the list of assets.
+
+class CMeshRegistry
+{
+private:
+	struct SMeshInfo
+	{
+		tle::IMesh* mesh = nullptr;
+		double loadSeconds = 0.0; // How long LoadMesh took
+		uintmax_t fileBytes = 0; // Size of the mesh file, as the engine does not report the memory a mesh uses. 0 if not found.
+	};
+
+	tle::I3DEngine* engine_ = nullptr;
+	std::vector<std::string> folders_; // Where to look for mesh files
+	std::unordered_map<std::string, SMeshInfo> meshes_;
+	std::vector<std::string> loadOrder_; // File names in the order they were loaded
+
+public:
+	explicit CMeshRegistry(tle::I3DEngine* engine) noexcept : engine_(engine)
+	{
+	}
+
+	// Add a folder to look for mesh files in. The engine is told about it as well.
+	void AddMediaFolder(const std::string& kFolder);
+	// Get a mesh, loading it if this is the first time it is needed.
+	tle::IMesh* Get(const std::string& kFile);
+	// Has the mesh been loaded yet?
+	bool IsLoaded(const std::string& kFile) const
+	{
+		return meshes_.count(kFile) != 0;
+	}
+	size_t GetLoadedCount() const noexcept
+	{
+		return meshes_.size();
+	}
+	// Write the load time and size of every loaded mesh, in the order they were loaded.
+	void PrintReport(std::ostream& output) const;
+};
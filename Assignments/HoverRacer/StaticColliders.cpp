@@ -0,0 +1,252 @@
+#include "StaticColliders.h"
+#include <algorithm> // min, max, swap
+#include <cmath> // fabsf, sqrtf
+#include <limits> // maximum data type values
+#include "CollisionKernels.h" // Batch narrow phase kernels
+
+void CStaticColliders::AddBox(const float& kX, const float& kZ, const float& kHalfWidth, const float& kHalfLength, const SBoxAxis& kAxis, const ELevelObjectType& kType)
+{
+	x_.push_back(kX);
+	z_.push_back(kZ);
+	halfWidth_.push_back(kHalfWidth);
+	halfLength_.push_back(kHalfLength);
+	axisX_.push_back(kAxis.x);
+	axisZ_.push_back(kAxis.z);
+	localX_.push_back(GetBoxLocalX(kAxis.x, kAxis.z, kX, kZ));
+	localZ_.push_back(GetBoxLocalZ(kAxis.x, kAxis.z, kX, kZ));
+	radius_.push_back(0.0f);
+	type_.push_back(kType);
+}
+
+void CStaticColliders::AddSphere(const float& kX, const float& kZ, const float& kRadius, const ELevelObjectType& kType)
+{
+	x_.push_back(kX);
+	z_.push_back(kZ);
+	halfWidth_.push_back(0.0f);
+	halfLength_.push_back(0.0f);
+	axisX_.push_back(1.0f);
+	axisZ_.push_back(0.0f);
+	localX_.push_back(kX);
+	localZ_.push_back(kZ);
+	radius_.push_back(kRadius);
+	type_.push_back(kType);
+}
+
+void CStaticColliders::Clear() noexcept
+{
+	x_.clear();
+	z_.clear();
+	halfWidth_.clear();
+	halfLength_.clear();
+	axisX_.clear();
+	axisZ_.clear();
+	localX_.clear();
+	localZ_.clear();
+	radius_.clear();
+	type_.clear();
+}
+
+void CStaticColliders::Reserve(const size_t& kCount)
+{
+	x_.reserve(kCount);
+	z_.reserve(kCount);
+	halfWidth_.reserve(kCount);
+	halfLength_.reserve(kCount);
+	axisX_.reserve(kCount);
+	axisZ_.reserve(kCount);
+	localX_.reserve(kCount);
+	localZ_.reserve(kCount);
+	radius_.reserve(kCount);
+	type_.reserve(kCount);
+}
+
+void CStaticColliders::AssignBoxes(const std::vector<SBoxCollider>& kBoxes)
+{
+	Clear();
+	Reserve(kBoxes.size());
+	for (const SBoxCollider& kBox : kBoxes)
+	{
+		// Merged runs can mix isles and walls, so they are all tagged as walls.
+		AddBox(kBox.x, kBox.z, kBox.halfWidth, kBox.halfLength, kBox.axis, ELevelObjectType::objectWall);
+	}
+}
+
+void CStaticColliders::AssignSpheres(const SLevelObject* kFirst, const SLevelObject* kLast)
+{
+	Clear();
+	for (const SLevelObject* kObject = kFirst; kObject != kLast; kObject++)
+	{
+		if (kObject->radius > 0.0f)
+		{
+			AddSphere(kObject->position[0], kObject->position[2], kObject->radius, kObject->type);
+		}
+	}
+}
+
+std::vector<SGridBounds> CStaticColliders::GetBounds() const
+{
+	std::vector<SGridBounds> bounds(GetCount());
+	for (size_t i = 0; i < bounds.size(); i++)
+	{
+		// A sphere has no half sizes and a box has no radius, so adding both covers either.
+		// A turned box covers its half sizes along both of its axes.
+		const float kAxisX = fabsf(axisX_[i]);
+		const float kAxisZ = fabsf(axisZ_[i]);
+		const float kHalfWidth = kAxisX * halfWidth_[i] + kAxisZ * halfLength_[i] + radius_[i];
+		const float kHalfLength = kAxisZ * halfWidth_[i] + kAxisX * halfLength_[i] + radius_[i];
+		bounds[i] = { x_[i] - kHalfWidth, x_[i] + kHalfWidth, z_[i] - kHalfLength, z_[i] + kHalfLength };
+	}
+	return bounds;
+}
+
+size_t FindFirstBoxHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept
+{
+	for (size_t first = 0; first < kCount; first += kKernelBatchSize)
+	{
+		// The axis isn't needed, so the previous position is the current one
+		const uint32_t kHits = TestSphereBoxes(kColliders, kCandidates + first, std::min(kKernelBatchSize, kCount - first), kX, kZ, kX, kZ, kRadius).hits;
+		if (kHits != 0)
+		{
+			return first + GetFirstHit(kHits);
+		}
+	}
+	return kCount;
+}
+
+size_t FindFirstSphereHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept
+{
+	// A car is rarely near more than one sphere, so the spheres are tested one at a time with the shared test. Going
+	// through the batch kernels costs more than the test itself for so few (see README.md).
+	const SSphereShape kSphere{ kX, kZ, kRadius };
+	for (size_t i = 0; i < kCount; i++)
+	{
+		const uint32_t kIndex = kCandidates[i];
+		if (IsCollided(kSphere, SSphereShape{ kColliders.GetX()[kIndex], kColliders.GetZ()[kIndex], kColliders.GetRadius()[kIndex] }))
+		{
+			return i;
+		}
+	}
+	return kCount;
+}
+
+size_t FindFirstPointBoxHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ) noexcept
+{
+	for (size_t first = 0; first < kCount; first += kKernelBatchSize)
+	{
+		const uint32_t kHits = TestPointBoxes(kColliders, kCandidates + first, std::min(kKernelBatchSize, kCount - first), kX, kZ);
+		if (kHits != 0)
+		{
+			return first + GetFirstHit(kHits);
+		}
+	}
+	return kCount;
+}
+
+SContact GetBoxContact(const CStaticColliders& kColliders, const uint32_t& kIndex, const float& kX, const float& kZ, const float& kRadius, const bool& kIsXAxis) noexcept
+{
+	const float kAxisX = kColliders.GetAxisX()[kIndex];
+	const float kAxisZ = kColliders.GetAxisZ()[kIndex];
+	// How far the circle is from the middle of the box, along the box's axis the side faces
+	const float kOffset = kIsXAxis ? GetBoxLocalX(kAxisX, kAxisZ, kX, kZ) - kColliders.GetLocalX()[kIndex] : GetBoxLocalZ(kAxisX, kAxisZ, kX, kZ) - kColliders.GetLocalZ()[kIndex];
+	const float kHalfSize = kIsXAxis ? kColliders.GetHalfWidth()[kIndex] : kColliders.GetHalfLength()[kIndex];
+	const float kDepth = std::max(0.0f, kHalfSize + kRadius - fabsf(kOffset));
+	const float kSide = (kOffset < 0.0f) ? -1.0f : 1.0f;
+	// The box's own z axis is at a right angle to its x axis
+	if (kIsXAxis)
+	{
+		return { kSide * kAxisX, kSide * kAxisZ, kDepth };
+	}
+	return { -kSide * kAxisZ, kSide * kAxisX, kDepth };
+}
+
+namespace
+{
+	// Find when a point moving along one axis is between two edges: from entry to exit, as fractions of the move.
+	// Returns false if it never is.
+	bool GetSlabTimes(const float& kStart, const float& kMove, const float& kMin, const float& kMax, float& entry, float& exit) noexcept
+	{
+		if (kMove == 0.0f)
+		{
+			entry = -std::numeric_limits<float>::max();
+			exit = std::numeric_limits<float>::max();
+			return kStart > kMin && kStart < kMax;
+		}
+		entry = (kMin - kStart) / kMove;
+		exit = (kMax - kStart) / kMove;
+		if (entry > exit)
+		{
+			std::swap(entry, exit);
+		}
+		return true;
+	}
+}
+
+SBoxSweep SweepCircleBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kStartX, const float& kStartZ, const float& kMoveX, const float& kMoveZ, const float& kRadius) noexcept
+{
+	SBoxSweep first{ kCount, 1.0f, false };
+	for (size_t i = 0; i < kCount; i++)
+	{
+		const uint32_t kIndex = kCandidates[i];
+		const float kAxisX = kColliders.GetAxisX()[kIndex];
+		const float kAxisZ = kColliders.GetAxisZ()[kIndex];
+		const float kBoxX = kColliders.GetLocalX()[kIndex];
+		const float kBoxZ = kColliders.GetLocalZ()[kIndex];
+		float entryX = 0.0f;
+		float exitX = 0.0f;
+		float entryZ = 0.0f;
+		float exitZ = 0.0f;
+		if (!GetSlabTimes(GetBoxLocalX(kAxisX, kAxisZ, kStartX, kStartZ), GetBoxLocalX(kAxisX, kAxisZ, kMoveX, kMoveZ), kBoxX - kColliders.GetHalfWidth()[kIndex] - kRadius, kBoxX + kColliders.GetHalfWidth()[kIndex] + kRadius, entryX, exitX)
+			|| !GetSlabTimes(GetBoxLocalZ(kAxisX, kAxisZ, kStartX, kStartZ), GetBoxLocalZ(kAxisX, kAxisZ, kMoveX, kMoveZ), kBoxZ - kColliders.GetHalfLength()[kIndex] - kRadius, kBoxZ + kColliders.GetHalfLength()[kIndex] + kRadius, entryZ, exitZ))
+		{
+			continue;
+		}
+		// The circle is inside the box once it is between both pairs of sides
+		const float kEntry = std::max(entryX, entryZ);
+		const float kExit = std::min(exitX, exitZ);
+		// Touching a side is not a hit, the same as the overlap test. Starting inside is left to the overlap test.
+		// Of boxes hit at the same time, the first in the list is kept.
+		const bool kIsFirst = (first.position == kCount) ? kEntry <= 1.0f : kEntry < first.time;
+		if (kEntry >= 0.0f && kEntry < kExit && kIsFirst)
+		{
+			first = { i, kEntry, entryX > entryZ };
+		}
+	}
+	return first;
+}
+
+SSphereSweep SweepCircleSpheres(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kStartX, const float& kStartZ, const float& kMoveX, const float& kMoveZ, const float& kRadius) noexcept
+{
+	SSphereSweep first{ kCount, 1.0f };
+	const float kMoveSquared = kMoveX * kMoveX + kMoveZ * kMoveZ;
+	if (kMoveSquared == 0.0f)
+	{
+		return first;
+	}
+	for (size_t i = 0; i < kCount; i++)
+	{
+		const uint32_t kIndex = kCandidates[i];
+		// Solve for when the distance between the centres is the two radii added together
+		const float kOffsetX = kStartX - kColliders.GetX()[kIndex];
+		const float kOffsetZ = kStartZ - kColliders.GetZ()[kIndex];
+		const float kReach = kRadius + kColliders.GetRadius()[kIndex];
+		const float kStartOutside = kOffsetX * kOffsetX + kOffsetZ * kOffsetZ - kReach * kReach;
+		const float kApproach = kOffsetX * kMoveX + kOffsetZ * kMoveZ;
+		// Starting inside or touching is left to the overlap test, and moving away never hits
+		if (kStartOutside <= 0.0f || kApproach >= 0.0f)
+		{
+			continue;
+		}
+		const float kDiscriminant = kApproach * kApproach - kMoveSquared * kStartOutside;
+		if (kDiscriminant <= 0.0f)
+		{
+			continue;
+		}
+		const float kEntry = (-kApproach - sqrtf(kDiscriminant)) / kMoveSquared;
+		const bool kIsFirst = (first.position == kCount) ? kEntry <= 1.0f : kEntry < first.time;
+		if (kIsFirst)
+		{
+			first = { i, kEntry };
+		}
+	}
+	return first;
+}
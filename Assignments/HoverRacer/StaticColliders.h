@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for collider indices
+#include <vector> // Vector class
+#include "../../Shared/Collision.h" // The collision tests shared with the other games
+#include "CollisionGrid.h" // SGridBounds
+#include "ContactManifold.h" // SContact
+#include "Level.h" // ELevelObjectType, SLevelObject
+#include "LevelColliders.h" // SBoxCollider
+
+// Colliders that never move, stored as a structure of arrays
+// Each field of every collider has its own contiguous array, filled once when a level is loaded. Collision tests read
+// these arrays instead of asking engine models for their position, so a list of candidates is tested in batches by the
+// kernels in CollisionKernels.h.
+// Boxes can be turned to any angle. Each box keeps its own x axis and its centre in its own axes, worked out when it is
+// added, so testing a point against it only needs the point turned into the box's axes: a few multiplies, and no sines
+// or cosines. Boxes turned by a right angle have an axis of 1, 0, and give exactly the same results as before.
+
+class CStaticColliders
+{
+private:
+	std::vector<float> x_; // Centre
+	std::vector<float> z_;
+	std::vector<float> halfWidth_; // Half the size on the box's own x axis. 0 for spheres.
+	std::vector<float> halfLength_; // Half the size on the box's own z axis. 0 for spheres.
+	std::vector<float> axisX_; // The box's own x axis. 1, 0 for spheres.
+	std::vector<float> axisZ_;
+	std::vector<float> localX_; // Centre in the box's own axes
+	std::vector<float> localZ_;
+	std::vector<float> radius_; // 0 for boxes
+	std::vector<ELevelObjectType> type_; // What the collider was built from
+
+public:
+	void AddBox(const float& kX, const float& kZ, const float& kHalfWidth, const float& kHalfLength, const SBoxAxis& kAxis, const ELevelObjectType& kType);
+	void AddSphere(const float& kX, const float& kZ, const float& kRadius, const ELevelObjectType& kType);
+	void Clear() noexcept;
+	void Reserve(const size_t& kCount);
+
+	// Replace the colliders with merged isle and wall boxes.
+	void AssignBoxes(const std::vector<SBoxCollider>& kBoxes);
+	// Replace the colliders with the spheres of a range of level objects. Objects without a sphere are skipped.
+	void AssignSpheres(const SLevelObject* kFirst, const SLevelObject* kLast);
+
+	// Get the area every collider covers, in order. Used to build a broadphase over them.
+	std::vector<SGridBounds> GetBounds() const;
+
+	size_t GetCount() const noexcept
+	{
+		return x_.size();
+	}
+	const float* GetX() const noexcept
+	{
+		return x_.data();
+	}
+	const float* GetZ() const noexcept
+	{
+		return z_.data();
+	}
+	const float* GetHalfWidth() const noexcept
+	{
+		return halfWidth_.data();
+	}
+	const float* GetHalfLength() const noexcept
+	{
+		return halfLength_.data();
+	}
+	const float* GetAxisX() const noexcept
+	{
+		return axisX_.data();
+	}
+	const float* GetAxisZ() const noexcept
+	{
+		return axisZ_.data();
+	}
+	const float* GetLocalX() const noexcept
+	{
+		return localX_.data();
+	}
+	const float* GetLocalZ() const noexcept
+	{
+		return localZ_.data();
+	}
+	const float* GetRadius() const noexcept
+	{
+		return radius_.data();
+	}
+	ELevelObjectType GetType(const size_t& kIndex) const noexcept
+	{
+		return type_[kIndex];
+	}
+};
+
+// Turn a point into a box's own axes. For an axis of 1, 0 the point is unchanged.
+inline float GetBoxLocalX(const float& kAxisX, const float& kAxisZ, const float& kX, const float& kZ) noexcept
+{
+	return GetShapeLocalX(kAxisX, kAxisZ, kX, kZ);
+}
+inline float GetBoxLocalZ(const float& kAxisX, const float& kAxisZ, const float& kX, const float& kZ) noexcept
+{
+	return GetShapeLocalZ(kAxisX, kAxisZ, kX, kZ);
+}
+
+// Find the first of a list of box colliders that a circle is inside. A circle is inside a box if its centre is strictly
+// inside the box grown by the radius on every side, in the box's own axes, the same test as IsSphereBoxCollided.
+// Returns the position in kCandidates of the first box hit, or kCount if none are.
+size_t FindFirstBoxHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept;
+// Find the first of a list of sphere colliders that a circle overlaps, the same test as IsSphereSphereCollided.
+// The spheres are tested one at a time rather than through the batch kernels, which are slower for the few a car is near.
+// Returns the position in kCandidates of the first sphere hit, or kCount if none are.
+size_t FindFirstSphereHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ, const float& kRadius) noexcept;
+// Find the first of a list of box colliders that a point is strictly inside, the same test as IsPointBoxCollided.
+// Returns the position in kCandidates of the first box hit, or kCount if none are.
+size_t FindFirstPointBoxHit(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kX, const float& kZ) noexcept;
+
+// The first box a moving circle hits
+struct SBoxSweep
+{
+	size_t position; // Position in kCandidates of the box hit, or kCount if none are
+	float time; // How far along the move the circle touches the box, from 0 to 1
+	bool xAxis; // True if the circle hits a side facing along the box's own x axis, false if it hits one facing along z
+};
+// Get the contact between a circle and a box collider, on one of the box's sides facing along its own x axis, or along
+// its own z axis. The circle is pushed out of whichever of the two sides it is nearer.
+SContact GetBoxContact(const CStaticColliders& kColliders, const uint32_t& kIndex, const float& kX, const float& kZ, const float& kRadius, const bool& kIsXAxis) noexcept;
+
+// Find the first of a list of box colliders that a circle moving from kStartX, kStartZ by kMoveX, kMoveZ runs into.
+// Boxes are grown by the radius the same way as IsSphereBoxCollided, and the move is turned into each box's own axes.
+// Boxes the circle starts inside are not hit.
+SBoxSweep SweepCircleBoxes(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kStartX, const float& kStartZ, const float& kMoveX, const float& kMoveZ, const float& kRadius) noexcept;
+
+// The first sphere a moving circle hits
+struct SSphereSweep
+{
+	size_t position; // Position in kCandidates of the sphere hit, or kCount if none are
+	float time; // How far along the move the circle touches the sphere, from 0 to 1
+};
+// Find the first of a list of sphere colliders that a circle moving from kStartX, kStartZ by kMoveX, kMoveZ runs into.
+// Spheres the circle starts inside, or only grazes, are not hit, the same as boxes.
+SSphereSweep SweepCircleSpheres(const CStaticColliders& kColliders, const uint32_t* kCandidates, const size_t& kCount, const float& kStartX, const float& kStartZ, const float& kMoveX, const float& kMoveZ, const float& kRadius) noexcept;
@@ -0,0 +1,69 @@
+#include "SweepAndPrune.h"
+#include <algorithm> // find, min, max
+
+namespace
+{
+	// Endpoints are ordered by value. At the same value a start goes first, so bodies that only touch still overlap.
+	bool IsEndpointBefore(const float& kValue1, const bool& kIsEnd1, const float& kValue2, const bool& kIsEnd2) noexcept
+	{
+		return kValue1 < kValue2 || (kValue1 == kValue2 && !kIsEnd1 && kIsEnd2);
+	}
+}
+
+uint32_t CSweepAndPrune::Add(const SGridBounds& kBounds)
+{
+	const uint32_t kBody = static_cast<uint32_t>(bounds_.size());
+	bounds_.push_back(kBounds);
+	// The endpoints are put in order at the next FindPairs, like any other move
+	endpoints_.push_back({ kBounds.minX, kBody, false });
+	endpoints_.push_back({ kBounds.maxX, kBody, true });
+	return kBody;
+}
+
+void CSweepAndPrune::Clear() noexcept
+{
+	bounds_.clear();
+	endpoints_.clear();
+	open_.clear();
+}
+
+void CSweepAndPrune::FindPairs(std::vector<SBodyPair>& pairs)
+{
+	pairs.clear();
+
+	// Insertion sort. Each endpoint only moves past the endpoints it crossed since the last frame.
+	for (size_t i = 0; i < endpoints_.size(); i++)
+	{
+		SEndpoint endpoint = endpoints_[i];
+		endpoint.value = endpoint.isEnd ? bounds_[endpoint.body].maxX : bounds_[endpoint.body].minX;
+		size_t position = i;
+		for (; position > 0 && IsEndpointBefore(endpoint.value, endpoint.isEnd, endpoints_[position - 1].value, endpoints_[position - 1].isEnd); position--)
+		{
+			endpoints_[position] = endpoints_[position - 1];
+		}
+		endpoints_[position] = endpoint;
+	}
+
+	// Sweep along x. A body starting while another is open overlaps it on x, so check that pair on z.
+	open_.clear();
+	for (const SEndpoint& kEndpoint : endpoints_)
+	{
+		if (kEndpoint.isEnd)
+		{
+			const auto kOpen = std::find(open_.begin(), open_.end(), kEndpoint.body);
+			*kOpen = open_.back();
+			open_.pop_back();
+			continue;
+		}
+		const SGridBounds& kBounds = bounds_[kEndpoint.body];
+		for (const uint32_t kOther : open_)
+		{
+			const SGridBounds& kOtherBounds = bounds_[kOther];
+			if (kBounds.minZ <= kOtherBounds.maxZ && kOtherBounds.minZ <= kBounds.maxZ)
+			{
+				pairs.push_back({ std::min(kEndpoint.body, kOther), std::max(kEndpoint.body, kOther) });
+			}
+		}
+		open_.push_back(kEndpoint.body);
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint> // Fixed width integers for body indices
+#include <vector> // Vector class
+#include "CollisionGrid.h" // SGridBounds
+
+// Sweep and prune broadphase for moving bodies, such as the hover cars
+// The start and end of every body along the x axis are kept in one sorted list. Bodies barely move between frames,
+// so the list is nearly sorted already, and an insertion sort puts it back in order in close to linear time.
+// A sweep along the list then finds the bodies that overlap on x, and only those are checked on z.
+
+// Two bodies whose bounds overlap. first is always less than second.
+struct SBodyPair
+{
+	uint32_t first;
+	uint32_t second;
+};
+
+class CSweepAndPrune
+{
+private:
+	// The start or end of a body along the x axis
+	struct SEndpoint
+	{
+		float value;
+		uint32_t body;
+		bool isEnd;
+	};
+
+	std::vector<SGridBounds> bounds_;
+	std::vector<SEndpoint> endpoints_; // Sorted by value, starts before ends
+	std::vector<uint32_t> open_; // Bodies whose start the sweep has passed, but not their end
+
+public:
+	// Add a body and return its index.
+	uint32_t Add(const SGridBounds& kBounds);
+	void Clear() noexcept;
+	// Move a body. Takes effect at the next FindPairs.
+	void Update(const uint32_t& kBody, const SGridBounds& kBounds) noexcept
+	{
+		bounds_[kBody] = kBounds;
+	}
+	// Re-sort the endpoints, then replace pairs with every pair of bodies whose bounds overlap.
+	void FindPairs(std::vector<SBodyPair>& pairs);
+	size_t GetBodyCount() const noexcept
+	{
+		return bounds_.size();
+	}
+};
@@ -0,0 +1,694 @@
+// Collision benchmark
+// Times the batch collision kernels against testing one collider at a time, on the colliders of a level.
+// Cars are placed at random around the level's isles, walls and water tanks, and every query is run with every set of
+// kernels the CPU supports, both against the colliders the broadphase finds and against every collider in the level.
+// Every kernel result is checked against the one at a time tests, which use the collision tests shared by the games,
+// and any difference fails the run.
+// The uniform grid and the bounding volume hierarchy are timed finding the colliders near the same cars, and must find
+// the same ones.
+// Then fans of lookahead rays and fat segments are cast from the cars with CSceneryCaster, one at a time and in
+// batches, and every hit is checked against casting at every collider in the level.
+// Last, crowds of hover cars are moved at random, and the touching pairs found each frame with sweep and prune are
+// timed and checked against testing every pair of cars.
+//
+// Usage: CollisionBenchmark <level.glf> [queries]
+
+#include <algorithm> // min, sort
+#include <chrono> // Timing the kernels
+#include <cmath> // sinf, cosf, atan2f, sqrtf
+#include <iomanip> // Formatting the times
+#include <iostream> // Console output
+#include <limits> // maximum data type values
+#include <random> // Placing the cars
+#include <string> // String class
+#include <vector> // Vector class
+#include "../../../../Shared/Collision.h" // The shared collision tests
+#include "../../CollisionBroadphase.h" // Finding the colliders near a car
+#include "../../CollisionCasts.h" // Casts against the scenery
+#include "../../CollisionKernels.h" // The kernels being timed
+#include "../../LevelLoader.h" // PrepareLevel
+#include "../../LevelParser.h" // ReadLevelFile
+#include "../../StaticColliders.h" // Colliders as arrays of floats
+#include "../../SweepAndPrune.h" // Finding the hover cars that touch
+
+using namespace std;
+
+// Possible return codes used when returning from the program
+enum EReturnCodes
+{
+	CodeSuccess = 0,
+	CodeBadArguments = 1,
+	CodeLevelFail = 2,
+	CodeMismatch = 3
+};
+
+constexpr size_t kDefaultQueries = 100000;
+constexpr float kCarRadius = 4.0f; // The same as the hover cars
+constexpr float kCarReach = 8.0f; // How far the broadphase looks around a car, the same as the game while racing
+constexpr float kCarSpread = 12.0f; // How far from a collider a car can be placed
+constexpr float kCellSize = 20.0f; // The same as the game
+constexpr int kRounds = 5; // Each test is timed this many times and its fastest time is kept
+constexpr unsigned int kSeed = 1301; // Every run places the cars in the same places
+constexpr size_t kCastsPerCar = 8; // Lookahead rays in a fan in front of each car
+constexpr float kCastLength = 30.0f; // How far each lookahead ray looks
+constexpr float kCastFan = 1.2f; // The angle the fan of rays covers, in radians
+constexpr size_t kCrowdSizes[] = { 50, 500, 5000 }; // How many hover cars are moved at once
+constexpr int kCrowdFrames = 20; // How many frames each crowd is moved for
+constexpr float kCrowdSpacing = 20.0f; // The crowd is placed in a square this many units wide for each car along its side
+
+// A car position to test, with where it was the frame before
+struct SQuery
+{
+	float x;
+	float z;
+	float previousX;
+	float previousZ;
+};
+
+// The results of every test of a set of queries, compared across the kernels
+struct SResults
+{
+	vector<uint32_t> hits;
+	vector<uint32_t> xAxis;
+};
+
+// One at a time tests, with the shared collision tests in Shared/Collision.h. The colliders are copied into the
+// shared shapes first, so these also time testing an array of shapes against the kernels' arrays of floats.
+
+// Copy the colliders into shared shapes
+vector<SOrientedBoxShape> GetBoxShapes(const CStaticColliders& kColliders)
+{
+	vector<SOrientedBoxShape> shapes(kColliders.GetCount());
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		shapes[i] = { kColliders.GetX()[i], kColliders.GetZ()[i], kColliders.GetHalfWidth()[i], kColliders.GetHalfLength()[i], kColliders.GetAxisX()[i], kColliders.GetAxisZ()[i] };
+	}
+	return shapes;
+}
+vector<SSphereShape> GetSphereShapes(const CStaticColliders& kColliders)
+{
+	vector<SSphereShape> shapes(kColliders.GetCount());
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		shapes[i] = { kColliders.GetX()[i], kColliders.GetZ()[i], kColliders.GetRadius()[i] };
+	}
+	return shapes;
+}
+
+SBoxHits TestSphereBoxesOneAtATime(const vector<SOrientedBoxShape>& kBoxes, const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery)
+{
+	SBoxHits result{ GetCollidedMask(SSphereShape{ kQuery.x, kQuery.z, kCarRadius }, kBoxes.data(), kCandidates, kCount), 0 };
+	for (size_t i = 0; i < kCount; i++)
+	{
+		// The axis of each hit is decided the same way as IsSphereBoxCollided, in the box's own axes
+		const SOrientedBoxShape& kBox = kBoxes[kCandidates[i]];
+		const float kBoxX = GetShapeLocalX(kBox.axisX, kBox.axisZ, kBox.x, kBox.z);
+		const float kCarPreviousX = GetShapeLocalX(kBox.axisX, kBox.axisZ, kQuery.previousX, kQuery.previousZ);
+		if ((result.hits & (1u << i)) != 0 && (kCarPreviousX < kBoxX - kBox.halfWidth - kCarRadius || kCarPreviousX > kBoxX + kBox.halfWidth + kCarRadius))
+		{
+			result.xAxis |= 1u << i;
+		}
+	}
+	return result;
+}
+
+uint32_t TestSphereSpheresOneAtATime(const vector<SSphereShape>& kSpheres, const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery)
+{
+	return GetCollidedMask(SSphereShape{ kQuery.x, kQuery.z, kCarRadius }, kSpheres.data(), kCandidates, kCount);
+}
+
+uint32_t TestPointBoxesOneAtATime(const vector<SOrientedBoxShape>& kBoxes, const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery)
+{
+	return GetCollidedMask(SPointShape{ kQuery.x, kQuery.z }, kBoxes.data(), kCandidates, kCount);
+}
+
+// Place cars at random around the colliders, moving in a random direction
+vector<SQuery> PlaceCars(const CStaticColliders& kColliders, const size_t& kQueries)
+{
+	vector<SQuery> queries;
+	if (kColliders.GetCount() == 0)
+	{
+		return queries;
+	}
+	mt19937 random(kSeed);
+	uniform_int_distribution<size_t> pickCollider(0, kColliders.GetCount() - 1);
+	uniform_real_distribution<float> pickOffset(-kCarSpread, kCarSpread);
+	uniform_real_distribution<float> pickMove(-1.0f, 1.0f);
+	queries.reserve(kQueries);
+	for (size_t i = 0; i < kQueries; i++)
+	{
+		const size_t kCollider = pickCollider(random);
+		const float kX = kColliders.GetX()[kCollider] + pickOffset(random);
+		const float kZ = kColliders.GetZ()[kCollider] + pickOffset(random);
+		queries.push_back({ kX, kZ, kX + pickMove(random), kZ + pickMove(random) });
+	}
+	return queries;
+}
+
+// Find the candidates of every query up front, so only the narrow phase is timed
+vector<vector<uint32_t>> FindCandidates(const CStaticColliders& kColliders, const vector<SQuery>& kQueries)
+{
+	CCollisionBroadphase broadphase(kCellSize);
+	broadphase.Build(kColliders.GetBounds());
+	vector<vector<uint32_t>> candidates(kQueries.size());
+	for (size_t i = 0; i < kQueries.size(); i++)
+	{
+		broadphase.QuerySegment(kQueries[i].previousX, kQueries[i].previousZ, kQueries[i].x, kQueries[i].z, kCarReach, candidates[i]);
+	}
+	return candidates;
+}
+
+// Run one test over the candidates of every query in batches, and time it. Returns the fastest round in nanoseconds.
+template <typename Test>
+long long TimeBatches(const vector<SQuery>& kQueries, const vector<vector<uint32_t>>& kCandidates, const Test& kTest, SResults& results)
+{
+	long long fastest = numeric_limits<long long>::max();
+	for (int round = 0; round < kRounds; round++)
+	{
+		results.hits.clear();
+		results.xAxis.clear();
+		const auto kStart = chrono::steady_clock::now();
+		for (size_t i = 0; i < kQueries.size(); i++)
+		{
+			const vector<uint32_t>& kQueryCandidates = kCandidates[i];
+			for (size_t first = 0; first < kQueryCandidates.size(); first += kKernelBatchSize)
+			{
+				const SBoxHits kHits = kTest(kQueryCandidates.data() + first, min(kKernelBatchSize, kQueryCandidates.size() - first), kQueries[i]);
+				results.hits.push_back(kHits.hits);
+				results.xAxis.push_back(kHits.xAxis);
+			}
+		}
+		const auto kTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - kStart);
+		fastest = min<long long>(fastest, kTime.count());
+	}
+	return fastest;
+}
+
+// Time one kind of test with every set of kernels. Returns false if any kernel disagrees with the one at a time test.
+template <typename OneAtATime, typename Kernel>
+bool CompareKernels(const string& kName, const vector<SQuery>& kQueries, const vector<vector<uint32_t>>& kCandidates, const OneAtATime& kOneAtATime, const Kernel& kKernel)
+{
+	size_t tests = 0;
+	for (const vector<uint32_t>& kQueryCandidates : kCandidates)
+	{
+		tests += kQueryCandidates.size();
+	}
+	SResults expected;
+	const long long kOneAtATimeTime = TimeBatches(kQueries, kCandidates, kOneAtATime, expected);
+	cout << "  " << kName << ": " << tests << " tests" << endl;
+	cout << "    one at a time: " << setw(8) << static_cast<double>(kOneAtATimeTime) / kQueries.size() << " ns per car" << endl;
+
+	bool matched = true;
+	for (int kernel = 0; kernel < static_cast<int>(ECollisionKernel::collisionKernelsTotal); kernel++)
+	{
+		const ECollisionKernel kKernelType = static_cast<ECollisionKernel>(kernel);
+		if (!SetCollisionKernel(kKernelType))
+		{
+			cout << "    " << GetCollisionKernelName(kKernelType) << ": not supported by this CPU" << endl;
+			continue;
+		}
+		SResults results;
+		const long long kTime = TimeBatches(kQueries, kCandidates, kKernel, results);
+		cout << "    " << setw(13) << left << GetCollisionKernelName(kKernelType) << right << ": " << setw(8) << static_cast<double>(kTime) / kQueries.size()
+			<< " ns per car, " << static_cast<double>(kOneAtATimeTime) / max<long long>(kTime, 1) << "x";
+		if (results.hits != expected.hits || results.xAxis != expected.xAxis)
+		{
+			cout << " MISMATCH";
+			matched = false;
+		}
+		cout << endl;
+	}
+	return matched;
+}
+
+// Find the first sphere a car hits through the batch kernels, as FindFirstSphereHit did before it tested one at a time
+size_t FindFirstSphereHitInBatches(const CStaticColliders& kSpheres, const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery)
+{
+	for (size_t first = 0; first < kCount; first += kKernelBatchSize)
+	{
+		const uint32_t kHits = TestSphereSpheres(kSpheres, kCandidates + first, min(kKernelBatchSize, kCount - first), kQuery.x, kQuery.z, kCarRadius);
+		if (kHits != 0)
+		{
+			return first + GetFirstHit(kHits);
+		}
+	}
+	return kCount;
+}
+
+// Time finding the first sphere each car hits, the way the game does, against doing it through the batch kernels.
+// Returns false if the two find different spheres.
+bool CompareFirstSphereHits(const CStaticColliders& kSpheres, const vector<SQuery>& kQueries, const vector<vector<uint32_t>>& kCandidates)
+{
+	vector<size_t> oneAtATime(kQueries.size());
+	vector<size_t> batched(kQueries.size());
+	long long oneAtATimeTime = numeric_limits<long long>::max();
+	long long batchedTime = numeric_limits<long long>::max();
+	for (int round = 0; round < kRounds; round++)
+	{
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < kQueries.size(); i++)
+		{
+			oneAtATime[i] = FindFirstSphereHit(kSpheres, kCandidates[i].data(), kCandidates[i].size(), kQueries[i].x, kQueries[i].z, kCarRadius);
+		}
+		oneAtATimeTime = min<long long>(oneAtATimeTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+		start = chrono::steady_clock::now();
+		for (size_t i = 0; i < kQueries.size(); i++)
+		{
+			batched[i] = FindFirstSphereHitInBatches(kSpheres, kCandidates[i].data(), kCandidates[i].size(), kQueries[i]);
+		}
+		batchedTime = min<long long>(batchedTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	}
+	const bool kMatched = (oneAtATime == batched);
+	cout << "  First sphere hit, as the game looks for it" << endl;
+	cout << "    FindFirstSphereHit: " << setw(8) << static_cast<double>(oneAtATimeTime) / kQueries.size() << " ns per car" << endl;
+	cout << "    batch kernels     : " << setw(8) << static_cast<double>(batchedTime) / kQueries.size() << " ns per car, "
+		<< static_cast<double>(oneAtATimeTime) / max<long long>(batchedTime, 1) << "x" << (kMatched ? "" : " MISMATCH") << endl;
+	return kMatched;
+}
+
+// Time every kind of test against a set of colliders, first with the broadphase candidates and then with every collider
+bool BenchmarkColliders(const string& kName, const CStaticColliders& kColliders, const bool& kAreSpheres, const size_t& kQueries)
+{
+	cout << kName << ": " << kColliders.GetCount() << " colliders" << endl;
+	if (kColliders.GetCount() == 0)
+	{
+		return true;
+	}
+	const vector<SQuery> kCars = PlaceCars(kColliders, kQueries);
+	vector<uint32_t> allColliders(kColliders.GetCount());
+	for (size_t i = 0; i < allColliders.size(); i++)
+	{
+		allColliders[i] = static_cast<uint32_t>(i);
+	}
+
+	const vector<SOrientedBoxShape> kBoxShapes = GetBoxShapes(kColliders);
+	const vector<SSphereShape> kSphereShapes = GetSphereShapes(kColliders);
+
+	bool matched = true;
+	const vector<vector<uint32_t>> kBroadphaseCandidates = FindCandidates(kColliders, kCars);
+	// Testing every collider is slow on big levels, so fewer cars are used
+	const size_t kEveryColliderCars = max<size_t>(1, min(kCars.size(), kQueries * 64 / kColliders.GetCount()));
+	const vector<SQuery> kEveryColliderQueries(kCars.begin(), kCars.begin() + kEveryColliderCars);
+	const vector<vector<uint32_t>> kEveryCollider(kEveryColliderCars, allColliders);
+	const pair<const char*, const vector<vector<uint32_t>>*> kCandidateSets[] = { { "broadphase candidates", &kBroadphaseCandidates }, { "every collider", &kEveryCollider } };
+	for (const auto& kCandidateSet : kCandidateSets)
+	{
+		const vector<SQuery>& kSetCars = (kCandidateSet.second == &kEveryCollider) ? kEveryColliderQueries : kCars;
+		cout << " Against " << kCandidateSet.first << ", " << kSetCars.size() << " cars" << endl;
+		if (kAreSpheres)
+		{
+			matched &= CompareKernels("Sphere to sphere", kSetCars, *kCandidateSet.second,
+				[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return SBoxHits{ TestSphereSpheresOneAtATime(kSphereShapes, kCandidates, kCount, kQuery), 0 }; },
+				[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return SBoxHits{ TestSphereSpheres(kColliders, kCandidates, kCount, kQuery.x, kQuery.z, kCarRadius), 0 }; });
+			matched &= CompareFirstSphereHits(kColliders, kSetCars, *kCandidateSet.second);
+			continue;
+		}
+		matched &= CompareKernels("Sphere to box", kSetCars, *kCandidateSet.second,
+			[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return TestSphereBoxesOneAtATime(kBoxShapes, kCandidates, kCount, kQuery); },
+			[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return TestSphereBoxes(kColliders, kCandidates, kCount, kQuery.x, kQuery.z, kQuery.previousX, kQuery.previousZ, kCarRadius); });
+		matched &= CompareKernels("Point to box", kSetCars, *kCandidateSet.second,
+			[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return SBoxHits{ TestPointBoxesOneAtATime(kBoxShapes, kCandidates, kCount, kQuery), 0 }; },
+			[&](const uint32_t* kCandidates, const size_t& kCount, const SQuery& kQuery) { return SBoxHits{ TestPointBoxes(kColliders, kCandidates, kCount, kQuery.x, kQuery.z), 0 }; });
+	}
+	return matched;
+}
+
+// Time one broadphase finding the colliders along every car's move, and count the colliders whose bounds are really
+// along it. Every candidate is checked, as the game tests every candidate, so a broadphase that returns more costs more.
+// Returns the fastest round in nanoseconds.
+template <typename Broadphase>
+long long TimeBroadphase(const Broadphase& kBroadphase, const vector<SGridBounds>& kBounds, const vector<SQuery>& kQueries, vector<vector<uint32_t>>& found)
+{
+	long long fastest = numeric_limits<long long>::max();
+	vector<uint32_t> candidates;
+	for (int round = 0; round < kRounds; round++)
+	{
+		found.assign(kQueries.size(), {});
+		const auto kStart = chrono::steady_clock::now();
+		for (size_t i = 0; i < kQueries.size(); i++)
+		{
+			const SQuery& kQuery = kQueries[i];
+			candidates.clear();
+			kBroadphase.QuerySegment(kQuery.previousX, kQuery.previousZ, kQuery.x, kQuery.z, kCarReach, candidates);
+			for (const uint32_t kIndex : candidates)
+			{
+				if (IsSegmentInBounds(kBounds[kIndex], kQuery.previousX, kQuery.previousZ, kQuery.x, kQuery.z, kCarReach))
+				{
+					found[i].push_back(kIndex);
+				}
+			}
+		}
+		const auto kTime = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - kStart);
+		fastest = min<long long>(fastest, kTime.count());
+	}
+	return fastest;
+}
+
+// Time building and querying a uniform grid and a bounding volume hierarchy over the same colliders, and show which
+// one CCollisionBroadphase picks for them. Returns false if the two find different colliders.
+bool BenchmarkBroadphases(const string& kName, const CStaticColliders& kColliders, const size_t& kQueries)
+{
+	if (kColliders.GetCount() == 0)
+	{
+		return true;
+	}
+	const vector<SGridBounds>& kBounds = kColliders.GetBounds();
+	const vector<SQuery> kCars = PlaceCars(kColliders, kQueries);
+	CCollisionGrid grid(kCellSize);
+	CCollisionBvh bvh;
+	long long gridBuildTime = numeric_limits<long long>::max();
+	long long bvhBuildTime = numeric_limits<long long>::max();
+	for (int round = 0; round < kRounds; round++)
+	{
+		auto start = chrono::steady_clock::now();
+		grid.Build(kBounds);
+		gridBuildTime = min<long long>(gridBuildTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+		start = chrono::steady_clock::now();
+		bvh.Build(kBounds);
+		bvhBuildTime = min<long long>(bvhBuildTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	}
+	vector<vector<uint32_t>> gridFound;
+	vector<vector<uint32_t>> bvhFound;
+	const long long kGridTime = TimeBroadphase(grid, kBounds, kCars, gridFound);
+	const long long kBvhTime = TimeBroadphase(bvh, kBounds, kCars, bvhFound);
+	bool matched = true;
+	for (size_t i = 0; i < kCars.size(); i++)
+	{
+		sort(gridFound[i].begin(), gridFound[i].end());
+		sort(bvhFound[i].begin(), bvhFound[i].end());
+		matched &= (gridFound[i] == bvhFound[i]);
+	}
+
+	cout << " " << kName << ", " << kCars.size() << " cars" << endl;
+	cout << "    grid: " << setw(8) << static_cast<double>(kGridTime) / kCars.size() << " ns per car, built in "
+		<< static_cast<double>(gridBuildTime) / 1000.0 << " us, " << grid.GetCellCount() << " cells" << endl;
+	cout << "    bvh : " << setw(8) << static_cast<double>(kBvhTime) / kCars.size() << " ns per car, built in "
+		<< static_cast<double>(bvhBuildTime) / 1000.0 << " us, " << bvh.GetNodeCount() << " nodes" << (matched ? "" : " MISMATCH") << endl;
+	const EBroadphaseType kPicked = ChooseBroadphaseType(kBounds.size());
+	cout << "    CCollisionBroadphase uses the " << ((kPicked == EBroadphaseType::bvh) ? "bvh" : "grid") << endl;
+	return matched;
+}
+
+// Cast at every collider of a level, without a broadphase, to check the caster against
+SCastHit CastEveryCollider(const CStaticColliders& kBoxes, const CStaticColliders& kSpheres, const CStaticColliders& kStruts, const SCast& kCast)
+{
+	const float kMoveX = kCast.endX - kCast.startX;
+	const float kMoveZ = kCast.endZ - kCast.startZ;
+	SCastHit hit{ ECastTarget::none, 0, 1.0f, kCast.endX, kCast.endZ, 0.0f, 0.0f };
+	const pair<const CStaticColliders*, ECastTarget> kSets[] = { { &kBoxes, ECastTarget::box }, { &kSpheres, ECastTarget::sphere }, { &kStruts, ECastTarget::strut } };
+	for (const auto& kSet : kSets)
+	{
+		vector<uint32_t> all(kSet.first->GetCount());
+		for (size_t i = 0; i < all.size(); i++)
+		{
+			all[i] = static_cast<uint32_t>(i);
+		}
+		size_t position = all.size();
+		float time = 1.0f;
+		if (kSet.second == ECastTarget::box)
+		{
+			const SBoxSweep kSweep = SweepCircleBoxes(*kSet.first, all.data(), all.size(), kCast.startX, kCast.startZ, kMoveX, kMoveZ, kCast.radius);
+			position = kSweep.position;
+			time = kSweep.time;
+		}
+		else
+		{
+			const SSphereSweep kSweep = SweepCircleSpheres(*kSet.first, all.data(), all.size(), kCast.startX, kCast.startZ, kMoveX, kMoveZ, kCast.radius);
+			position = kSweep.position;
+			time = kSweep.time;
+		}
+		if (position != all.size() && (hit.target == ECastTarget::none || time < hit.time))
+		{
+			hit.target = kSet.second;
+			hit.index = all[position];
+			hit.time = time;
+		}
+	}
+	return hit;
+}
+
+// Time casting fans of rays and fat segments from cars placed around the boxes, one at a time and in batches.
+// Returns false if the caster disagrees with casting at every collider.
+bool BenchmarkCasts(const CStaticColliders& kBoxes, const CStaticColliders& kSpheres, const CStaticColliders& kStruts, const vector<SGridBounds>& kCheckpointBounds, const size_t& kQueries)
+{
+	CCollisionBroadphase boxBroadphase(kCellSize);
+	boxBroadphase.Build(kBoxes.GetBounds());
+	CCollisionBroadphase sphereBroadphase(kCellSize);
+	sphereBroadphase.Build(kSpheres.GetBounds());
+	CCollisionBroadphase checkpointBroadphase(kCellSize);
+	checkpointBroadphase.Build(kCheckpointBounds);
+	CSceneryCaster caster(kBoxes, boxBroadphase, kSpheres, sphereBroadphase, kStruts, checkpointBroadphase);
+
+	// A fan of rays from each car, in the direction it is moving, then the same fan as fat segments the size of a car
+	const vector<SQuery> kCars = PlaceCars(kBoxes, kQueries / kCastsPerCar + 1);
+	vector<SCast> casts;
+	for (const float kRadius : { 0.0f, kCarRadius })
+	{
+		for (const SQuery& kCar : kCars)
+		{
+			const float kHeading = atan2f(kCar.x - kCar.previousX, kCar.z - kCar.previousZ);
+			for (size_t i = 0; i < kCastsPerCar; i++)
+			{
+				const float kAngle = kHeading + kCastFan * (static_cast<float>(i) / (kCastsPerCar - 1) - 0.5f);
+				SCast cast = GetRayCast(kCar.x, kCar.z, sinf(kAngle), cosf(kAngle), kCastLength);
+				cast.radius = kRadius;
+				casts.push_back(cast);
+			}
+		}
+	}
+
+	cout << "Casts: " << casts.size() << " rays and fat segments of " << kCastLength << " units, " << kCastsPerCar << " per car" << endl;
+	vector<SCastHit> oneAtATime(casts.size());
+	vector<SCastHit> batched(casts.size());
+	long long oneAtATimeTime = numeric_limits<long long>::max();
+	long long batchedTime = numeric_limits<long long>::max();
+	for (int round = 0; round < kRounds; round++)
+	{
+		auto start = chrono::steady_clock::now();
+		for (size_t i = 0; i < casts.size(); i++)
+		{
+			oneAtATime[i] = caster.Cast(casts[i]);
+		}
+		oneAtATimeTime = min<long long>(oneAtATimeTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+		start = chrono::steady_clock::now();
+		for (size_t first = 0; first < casts.size(); first += kCastsPerCar)
+		{
+			caster.Cast(casts.data() + first, min(kCastsPerCar, casts.size() - first), batched.data() + first);
+		}
+		batchedTime = min<long long>(batchedTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	}
+	size_t hits = 0;
+	bool matched = true;
+	for (size_t i = 0; i < casts.size(); i++)
+	{
+		const SCastHit kExpected = CastEveryCollider(kBoxes, kSpheres, kStruts, casts[i]);
+		hits += (kExpected.target != ECastTarget::none) ? 1 : 0;
+		for (const SCastHit& kHit : { oneAtATime[i], batched[i] })
+		{
+			if (kHit.target != kExpected.target || (kHit.target != ECastTarget::none && (kHit.index != kExpected.index || kHit.time != kExpected.time)))
+			{
+				matched = false;
+			}
+		}
+	}
+	cout << "  " << hits << " hit something" << endl;
+	cout << "    one at a time: " << setw(8) << static_cast<double>(oneAtATimeTime) / casts.size() << " ns per cast" << endl;
+	cout << "    batches      : " << setw(8) << static_cast<double>(batchedTime) / casts.size() << " ns per cast, "
+		<< static_cast<double>(oneAtATimeTime) / max<long long>(batchedTime, 1) << "x" << (matched ? "" : " MISMATCH") << endl;
+	return matched;
+}
+
+// The area a hover car covers on the ground, the same as the game gives CSweepAndPrune
+SGridBounds GetCarBounds(const float& kX, const float& kZ)
+{
+	return { kX - kCarRadius, kX + kCarRadius, kZ - kCarRadius, kZ + kCarRadius };
+}
+
+// Find every pair of cars whose bounds overlap by testing every pair, as CSweepAndPrune replaced
+void FindEveryPair(const vector<SGridBounds>& kBounds, vector<SBodyPair>& pairs)
+{
+	pairs.clear();
+	for (uint32_t first = 0; first < kBounds.size(); first++)
+	{
+		for (uint32_t second = first + 1; second < kBounds.size(); second++)
+		{
+			if (kBounds[first].minX <= kBounds[second].maxX && kBounds[second].minX <= kBounds[first].maxX
+				&& kBounds[first].minZ <= kBounds[second].maxZ && kBounds[second].minZ <= kBounds[first].maxZ)
+			{
+				pairs.push_back({ first, second });
+			}
+		}
+	}
+}
+
+// Put pairs in one order, so pairs found in different orders can be compared
+vector<uint64_t> GetSortedPairs(const vector<SBodyPair>& kPairs)
+{
+	vector<uint64_t> sorted;
+	for (const SBodyPair& kPair : kPairs)
+	{
+		sorted.push_back((static_cast<uint64_t>(kPair.first) << 32) | kPair.second);
+	}
+	sort(sorted.begin(), sorted.end());
+	return sorted;
+}
+
+// Move a crowd of cars at random for kCrowdFrames frames, and time finding the touching pairs each frame with sweep and
+// prune and by testing every pair. Returns false if the two find different pairs.
+bool BenchmarkCrowd(const size_t& kCars)
+{
+	// Every frame's bounds are worked out up front, so only finding the pairs is timed
+	mt19937 random(kSeed);
+	const float kSide = kCrowdSpacing * sqrtf(static_cast<float>(kCars));
+	uniform_real_distribution<float> pickPosition(0.0f, kSide);
+	uniform_real_distribution<float> pickMove(-1.0f, 1.0f);
+	vector<float> x(kCars);
+	vector<float> z(kCars);
+	vector<vector<SGridBounds>> frames(kCrowdFrames + 1, vector<SGridBounds>(kCars));
+	for (size_t car = 0; car < kCars; car++)
+	{
+		x[car] = pickPosition(random);
+		z[car] = pickPosition(random);
+		frames[0][car] = GetCarBounds(x[car], z[car]);
+	}
+	for (int frame = 1; frame <= kCrowdFrames; frame++)
+	{
+		for (size_t car = 0; car < kCars; car++)
+		{
+			x[car] += pickMove(random);
+			z[car] += pickMove(random);
+			frames[frame][car] = GetCarBounds(x[car], z[car]);
+		}
+	}
+
+	vector<vector<SBodyPair>> sweepPairs(kCrowdFrames + 1);
+	vector<vector<SBodyPair>> everyPair(kCrowdFrames + 1);
+	long long sweepTime = numeric_limits<long long>::max();
+	long long everyPairTime = numeric_limits<long long>::max();
+	for (int round = 0; round < kRounds; round++)
+	{
+		// The cars are added once before the race, so sorting them the first time is not timed
+		CSweepAndPrune sweep;
+		for (const SGridBounds& kBounds : frames[0])
+		{
+			sweep.Add(kBounds);
+		}
+		sweep.FindPairs(sweepPairs[0]);
+		auto start = chrono::steady_clock::now();
+		for (int frame = 1; frame <= kCrowdFrames; frame++)
+		{
+			for (uint32_t car = 0; car < kCars; car++)
+			{
+				sweep.Update(car, frames[frame][car]);
+			}
+			sweep.FindPairs(sweepPairs[frame]);
+		}
+		sweepTime = min<long long>(sweepTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+		start = chrono::steady_clock::now();
+		for (int frame = 1; frame <= kCrowdFrames; frame++)
+		{
+			FindEveryPair(frames[frame], everyPair[frame]);
+		}
+		everyPairTime = min<long long>(everyPairTime, chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+	}
+
+	size_t pairs = 0;
+	bool matched = true;
+	for (int frame = 1; frame <= kCrowdFrames; frame++)
+	{
+		pairs += everyPair[frame].size();
+		matched &= (GetSortedPairs(sweepPairs[frame]) == GetSortedPairs(everyPair[frame]));
+	}
+	cout << "  " << kCars << " cars, " << static_cast<double>(pairs) / kCrowdFrames << " touching pairs a frame" << endl;
+	cout << "    every pair     : " << setw(8) << static_cast<double>(everyPairTime) / kCrowdFrames / 1000.0 << " us per frame" << endl;
+	cout << "    sweep and prune: " << setw(8) << static_cast<double>(sweepTime) / kCrowdFrames / 1000.0 << " us per frame, "
+		<< static_cast<double>(everyPairTime) / max<long long>(sweepTime, 1) << "x" << (matched ? "" : " MISMATCH") << endl;
+	return matched;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2 && argc != 3)
+	{
+		cout << "Usage: CollisionBenchmark <level.glf> [queries]" << endl;
+		return CodeBadArguments;
+	}
+	const string kLevelFile = argv[1];
+	const size_t kQueries = (argc == 3) ? stoul(argv[2]) : kDefaultQueries;
+	if (kQueries == 0)
+	{
+		cout << "Usage: CollisionBenchmark <level.glf> [queries]" << endl;
+		return CodeBadArguments;
+	}
+
+	vector<SLevelObject> levelObjects;
+	SLoadedLevel level;
+	level.levelFile = kLevelFile;
+	level.source = kLevelFile;
+	if (!ReadLevelFile(kLevelFile, levelObjects, level.error) || !PrepareLevel(levelObjects.data(), levelObjects.data() + levelObjects.size(), level))
+	{
+		cout << "ERROR: " << level.error.message << ".";
+		// Line 0 means the problem is with the level as a whole
+		if (level.error.line != 0)
+		{
+			cout << " Line " << level.error.line << ", Column " << level.error.column;
+		}
+		cout << endl;
+		cout << "Check the " << kLevelFile << " file." << endl;
+		return CodeLevelFail;
+	}
+
+	cout << fixed << setprecision(1);
+	cout << "Best kernels for this CPU: " << GetCollisionKernelName(GetCollisionKernel()) << endl;
+	CStaticColliders boxes;
+	boxes.AssignBoxes(level.boxColliders);
+	CStaticColliders spheres;
+	spheres.AssignSpheres(level.scenery.GetObjects(), level.scenery.GetObjects() + level.scenery.GetObjectCount());
+	const bool kBoxesMatched = BenchmarkColliders("Isles and walls", boxes, false, kQueries);
+	const bool kSpheresMatched = BenchmarkColliders("Water tanks", spheres, true, kQueries);
+	if (!kBoxesMatched || !kSpheresMatched)
+	{
+		cout << "ERROR: The kernels do not agree with the one at a time tests." << endl;
+		return CodeMismatch;
+	}
+
+	cout << "Broadphases:" << endl;
+	if (!BenchmarkBroadphases("Isles and walls", boxes, kQueries) || !BenchmarkBroadphases("Water tanks", spheres, kQueries))
+	{
+		cout << "ERROR: The grid and the bounding volume hierarchy do not find the same colliders." << endl;
+		return CodeMismatch;
+	}
+
+	// Casts also look for the struts, which are listed by checkpoint
+	CStaticColliders struts;
+	vector<SGridBounds> checkpointBounds;
+	for (const SRaceObject& kRaceObject : level.raceObjects)
+	{
+		if (kRaceObject.object.type == ELevelObjectType::objectCheckpoint)
+		{
+			SGridBounds bounds{ numeric_limits<float>::max(), -numeric_limits<float>::max(), numeric_limits<float>::max(), -numeric_limits<float>::max() };
+			for (const SStrut& kStrut : kRaceObject.struts)
+			{
+				struts.AddSphere(kStrut.x, kStrut.z, kStrutRadius, ELevelObjectType::objectCheckpoint);
+				bounds = { min(bounds.minX, kStrut.x - kStrutRadius), max(bounds.maxX, kStrut.x + kStrutRadius), min(bounds.minZ, kStrut.z - kStrutRadius), max(bounds.maxZ, kStrut.z + kStrutRadius) };
+			}
+			checkpointBounds.push_back(bounds);
+		}
+	}
+	if (kQueries >= kCastsPerCar && boxes.GetCount() != 0 && !BenchmarkCasts(boxes, spheres, struts, checkpointBounds, kQueries))
+	{
+		cout << "ERROR: The caster does not agree with casting at every collider." << endl;
+		return CodeMismatch;
+	}
+
+	cout << "Hover cars: " << kCrowdFrames << " frames of moving at random" << endl;
+	for (const size_t kCars : kCrowdSizes)
+	{
+		if (!BenchmarkCrowd(kCars))
+		{
+			cout << "ERROR: Sweep and prune does not agree with testing every pair of cars." << endl;
+			return CodeMismatch;
+		}
+	}
+	return CodeSuccess;
+}
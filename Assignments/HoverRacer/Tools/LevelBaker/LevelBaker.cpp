@@ -0,0 +1,117 @@
+// Level baker
+// Checks a .glf level the same way the game does when it loads one, then works out everything the game would:
+// the grid square of every object, checkpoint struts, scenery sectors and merged box colliders.
+// The result is written as a baked level (.glbk) next to the .glf, which the game then loads as it is.
+// A level that would fail to load, or that has a checkpoint the cars can't get through, fails the bake.
+//
+// Usage: LevelBaker <level.glf> [output.glbk]
+
+#include <iostream> // Console output
+#include <string> // String class
+#include <vector> // Vector class
+#include "../../LevelBake.h" // Writing baked levels
+#include "../../LevelLoader.h" // PrepareLevel
+#include "../../LevelParser.h" // ReadLevelFile
+
+using namespace std;
+
+// Possible return codes used when returning from the program
+enum EReturnCodes
+{
+	CodeSuccess = 0,
+	CodeBadArguments = 1,
+	CodeLevelFail = 2,
+	CodeFileFail = 3
+};
+
+// Check if a circle overlaps a box collider
+bool IsCircleInBox(const float& kX, const float& kZ, const float& kRadius, const SBoxCollider& kBox) noexcept
+{
+	// Measure from the middle of the box along its own axes
+	const float kOffsetX = kX - kBox.x;
+	const float kOffsetZ = kZ - kBox.z;
+	const float kLocalX = kOffsetX * kBox.axis.x + kOffsetZ * kBox.axis.z;
+	const float kLocalZ = kOffsetZ * kBox.axis.x - kOffsetX * kBox.axis.z;
+	return kLocalX > -kBox.halfWidth - kRadius && kLocalX < kBox.halfWidth + kRadius
+		&& kLocalZ > -kBox.halfLength - kRadius && kLocalZ < kBox.halfLength + kRadius;
+}
+
+// Find the problems a level loads with but can't be raced with. Returns how many were found.
+size_t CheckLevel(const SLoadedLevel& kLevel)
+{
+	size_t problems = 0;
+	unsigned int stage = 0;
+	for (const SRaceObject& kRaceObject : kLevel.raceObjects)
+	{
+		if (kRaceObject.object.type != ELevelObjectType::objectCheckpoint)
+		{
+			continue;
+		}
+		const float kX = kRaceObject.object.position[0];
+		const float kZ = kRaceObject.object.position[2];
+		for (const SBoxCollider& kBox : kLevel.boxColliders)
+		{
+			// The middle of the gate has to be clear for the cars to pass through it
+			if (IsCircleInBox(kX, kZ, 0.0f, kBox))
+			{
+				cout << "ERROR: Checkpoint " << stage << " at " << kX << ", " << kZ << " is blocked by an isle or wall." << endl;
+				problems++;
+			}
+			// A strut inside a barrier pushes the car back from somewhere it can't see
+			for (const SStrut& kStrut : kRaceObject.struts)
+			{
+				if (IsCircleInBox(kStrut.x, kStrut.z, kStrutRadius, kBox))
+				{
+					cout << "ERROR: A strut of checkpoint " << stage << " at " << kStrut.x << ", " << kStrut.z << " is inside an isle or wall." << endl;
+					problems++;
+				}
+			}
+		}
+		stage++;
+	}
+	return problems;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2 && argc != 3)
+	{
+		cout << "Usage: LevelBaker <level.glf> [output.glbk]" << endl;
+		return CodeBadArguments;
+	}
+	const string kLevelFile = argv[1];
+	const string kBakedFile = (argc == 3) ? argv[2] : GetBakedLevelFile(kLevelFile);
+
+	vector<SLevelObject> levelObjects;
+	SLoadedLevel level;
+	level.levelFile = kLevelFile;
+	level.source = kLevelFile;
+	if (!ReadLevelFile(kLevelFile, levelObjects, level.error) || !PrepareLevel(levelObjects.data(), levelObjects.data() + levelObjects.size(), level))
+	{
+		cout << "ERROR: " << level.error.message << ".";
+		// Line 0 means the problem is with the level as a whole
+		if (level.error.line != 0)
+		{
+			cout << " Line " << level.error.line << ", Column " << level.error.column;
+		}
+		cout << endl;
+		cout << "Check the " << kLevelFile << " file." << endl;
+		return CodeLevelFail;
+	}
+	const size_t kProblems = CheckLevel(level);
+	if (kProblems != 0)
+	{
+		cout << kProblems << " problem(s) found. Check the " << kLevelFile << " file." << endl;
+		return CodeLevelFail;
+	}
+
+	if (!WriteBakedLevel(kBakedFile, level))
+	{
+		cout << "ERROR: Could not write " << kBakedFile << endl;
+		return CodeFileFail;
+	}
+	cout << "Baked " << kLevelFile << " to " << kBakedFile << ": " << level.raceObjects.size() << " checkpoints and waypoints, "
+		<< level.scenery.GetObjectCount() << " scenery objects in " << level.scenery.GetSectorCount() << " sectors, "
+		<< level.boxPieces << " isles and walls merged into " << level.boxColliders.size() << " box colliders." << endl;
+	return CodeSuccess;
+}
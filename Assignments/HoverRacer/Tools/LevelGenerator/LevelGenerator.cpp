@@ -0,0 +1,241 @@
+// Procedural level generator
+// Writes a valid .glf level of roughly the requested number of pieces, for measuring loading, collision and AI on large tracks.
+// The track is one closed loop: a serpentine of lanes joined by right-angle turns, with a return lane back to the start.
+// Both sides of the road are lined with alternating isles and walls, the same way level1.glf is built.
+//
+// Usage: LevelGenerator <pieces> <seed> <output.glf>
+
+#include <algorithm> // find_if, rotate
+#include <cmath> // sqrt, ceil
+#include <cstdlib> // strtoul
+#include <fstream> // File output
+#include <iostream> // Console output
+#include <random> // Seeded random numbers
+#include <string> // String class
+#include <vector> // Vector class
+#include "../../Level.h" // Object names and sizes
+
+using namespace std;
+
+// Possible return codes used when returning from the program
+enum EReturnCodes
+{
+	CodeSuccess = 0,
+	CodeBadArguments = 1,
+	CodeFileFail = 2
+};
+
+// Track layout
+constexpr float kStartX = -100.0f; // The first lane runs through the player's start position, heading +z.
+constexpr float kReturnZ = -100.0f; // The return lane, and the corner where the loop starts.
+constexpr float kStartZ = -73.0f; // Where the cars start in the game.
+constexpr float kStartCheckpointZ = -50.0f; // Where the start line is, in front of the player.
+constexpr float kTrackHalfWidth = 14.0f; // Distance from the middle of the road to the middle of the barrier pieces.
+constexpr float kLaneGap = 40.0f; // Distance between neighbouring lanes. Leaves room between the barriers of two lanes.
+constexpr float kLaneBottomZ = kReturnZ + kLaneGap; // Where the down lanes turn, above the return lane.
+constexpr float kPieceSpacing = 8.0f; // Distance between the middles of neighbouring barrier pieces, as in level1.glf.
+constexpr float kMinLaneLength = 120.0f; // Shortest lane, so every lane has room for a checkpoint and a water tank.
+constexpr float kWaypointSpacing = 40.0f; // Distance between waypoints along the middle of the road.
+constexpr float kTankOffset = 7.0f; // Water tanks stand this far to one side of the middle of the road.
+constexpr size_t kMinPieces = 100;
+
+struct SPoint
+{
+	float x;
+	float z;
+};
+
+// Writes level objects as .glf lines
+class CLevelWriter
+{
+private:
+	ofstream output_;
+	size_t pieces_ = 0;
+	size_t objects_ = 0;
+
+public:
+	explicit CLevelWriter(const string& kFile) : output_(kFile)
+	{
+	}
+	bool IsOpen() const
+	{
+		return output_.is_open();
+	}
+	bool Succeeded()
+	{
+		output_.flush();
+		return output_.good();
+	}
+	// Write an object with a global y rotation of 0 or 90 degrees
+	void Write(const string_view& kType, const float& kX, const float& kZ, const bool& kRotated)
+	{
+		output_ << kType << ' ' << kX << " 0 " << kZ << " 0 " << (kRotated ? kRightAngle : 0.0f) << " 0 0 0 0 1\n";
+		objects_++;
+	}
+	// Line one side of a straight stretch of road with barrier pieces, alternating isles and walls.
+	void WriteBarrier(const SPoint& kFrom, const SPoint& kTo)
+	{
+		const float kDeltaX = kTo.x - kFrom.x;
+		const float kDeltaZ = kTo.z - kFrom.z;
+		const float kLength = sqrtf(kDeltaX * kDeltaX + kDeltaZ * kDeltaZ);
+		const bool kAlongX = fabsf(kDeltaX) > fabsf(kDeltaZ);
+		const size_t kPieces = static_cast<size_t>(ceilf(kLength / kPieceSpacing)) + 1;
+		for (size_t i = 0; i < kPieces; i++)
+		{
+			// Spread the pieces evenly so both ends are covered
+			const float kFraction = (kPieces == 1) ? 0.0f : static_cast<float>(i) / static_cast<float>(kPieces - 1);
+			const string_view kType = (pieces_ % 2 == 0) ? kIsleStraightObject : kWallObject;
+			Write(kType, kFrom.x + kDeltaX * kFraction, kFrom.z + kDeltaZ * kFraction, kAlongX);
+			pieces_++;
+		}
+	}
+	size_t GetPieceCount() const noexcept
+	{
+		return pieces_;
+	}
+	size_t GetObjectCount() const noexcept
+	{
+		return objects_;
+	}
+};
+
+// Build the corners of the loop. Lanes alternate up and down, each up lane with a random length.
+vector<SPoint> BuildLoop(const size_t& kLanes, const float& kMeanLaneLength, mt19937& random)
+{
+	uniform_real_distribution<float> laneLength(max(kMinLaneLength, kMeanLaneLength * 0.5f), max(kMinLaneLength, kMeanLaneLength * 1.5f));
+	vector<SPoint> corners;
+	corners.push_back({ kStartX, kReturnZ });
+	for (size_t lane = 0; lane < kLanes; lane += 2)
+	{
+		// Each up lane starts at the corner left by the down lane before it
+		const float kUpX = kStartX + lane * kLaneGap;
+		const float kDownX = kUpX + kLaneGap;
+		// Whole numbers keep the file readable
+		const float kTopZ = roundf(kLaneBottomZ + laneLength(random));
+		corners.push_back({ kUpX, kTopZ });
+		corners.push_back({ kDownX, kTopZ });
+		// The last lane carries on down to the return lane
+		corners.push_back({ kDownX, (lane + 2 < kLanes) ? kLaneBottomZ : kReturnZ });
+		if (lane + 2 < kLanes)
+		{
+			corners.push_back({ kDownX + kLaneGap, kLaneBottomZ });
+		}
+	}
+	return corners;
+}
+
+// Which way the road turns at a corner: 1 for left, -1 for right, when looking along the road.
+float GetTurn(const SPoint& kPrevious, const SPoint& kCorner, const SPoint& kNext)
+{
+	const float kCross = (kCorner.x - kPrevious.x) * (kNext.z - kCorner.z) - (kCorner.z - kPrevious.z) * (kNext.x - kCorner.x);
+	return (kCross > 0.0f) ? 1.0f : -1.0f;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 4)
+	{
+		cout << "Usage: LevelGenerator <pieces> <seed> <output.glf>" << endl;
+		return CodeBadArguments;
+	}
+	const size_t kTargetPieces = max<size_t>(kMinPieces, strtoul(argv[1], nullptr, 10));
+	mt19937 random(static_cast<unsigned int>(strtoul(argv[2], nullptr, 10)));
+	const string kOutputFile = argv[3];
+
+	// Each unit of road length has a barrier piece on both sides every kPieceSpacing.
+	// Keep the layout roughly square: as many lanes side by side as the length of a lane allows.
+	const float kRoadLength = kTargetPieces * kPieceSpacing / 2.0f;
+	size_t lanes = static_cast<size_t>(sqrtf(kRoadLength / kLaneGap));
+	lanes = max<size_t>(2, lanes + (lanes % 2)); // Up and down lanes come in pairs
+	const float kMeanLaneLength = kRoadLength / lanes;
+	const vector<SPoint> kCorners = BuildLoop(lanes, kMeanLaneLength, random);
+
+	CLevelWriter writer(kOutputFile);
+	if (!writer.IsOpen())
+	{
+		cout << "ERROR: Could not write " << kOutputFile << endl;
+		return CodeFileFail;
+	}
+
+	// Barriers, one straight at a time. At each corner the barrier on the inside of the turn is cut short and the
+	// barrier on the outside is carried on, so the two straights meet without a gap.
+	const size_t kCornerCount = kCorners.size();
+	for (size_t i = 0; i < kCornerCount; i++)
+	{
+		const SPoint& kPrevious = kCorners[(i + kCornerCount - 1) % kCornerCount];
+		const SPoint& kFrom = kCorners[i];
+		const SPoint& kTo = kCorners[(i + 1) % kCornerCount];
+		const SPoint& kNext = kCorners[(i + 2) % kCornerCount];
+		const float kLength = fabsf(kTo.x - kFrom.x) + fabsf(kTo.z - kFrom.z);
+		const SPoint kDirection{ (kTo.x - kFrom.x) / kLength, (kTo.z - kFrom.z) / kLength };
+		const SPoint kLeft{ -kDirection.z, kDirection.x };
+		const float kStartTurn = GetTurn(kPrevious, kFrom, kTo);
+		const float kEndTurn = GetTurn(kFrom, kTo, kNext);
+		for (const float kSide : { 1.0f, -1.0f })
+		{
+			// kSide is 1 for the left barrier. A turn towards this side puts the barrier on the inside.
+			const float kStartExtend = (kStartTurn == kSide) ? -kTrackHalfWidth : kTrackHalfWidth;
+			const float kEndExtend = (kEndTurn == kSide) ? -kTrackHalfWidth : kTrackHalfWidth;
+			const SPoint kBarrierFrom{ kFrom.x + kLeft.x * kSide * kTrackHalfWidth - kDirection.x * kStartExtend, kFrom.z + kLeft.z * kSide * kTrackHalfWidth - kDirection.z * kStartExtend };
+			const SPoint kBarrierTo{ kTo.x + kLeft.x * kSide * kTrackHalfWidth + kDirection.x * kEndExtend, kTo.z + kLeft.z * kSide * kTrackHalfWidth + kDirection.z * kEndExtend };
+			writer.WriteBarrier(kBarrierFrom, kBarrierTo);
+		}
+	}
+
+	// A water tank to one side of the road, a third of the way along every lane
+	for (size_t i = 1; i < kCornerCount; i++)
+	{
+		const SPoint& kFrom = kCorners[i];
+		const SPoint& kTo = kCorners[(i + 1) % kCornerCount];
+		if (kFrom.x != kTo.x || fabsf(kTo.z - kFrom.z) < kMinLaneLength)
+		{
+			continue; // Only the lanes, not the short joins between them
+		}
+		const float kSide = (i % 2 == 0) ? kTankOffset : -kTankOffset;
+		writer.Write(kWaterTankObject, kFrom.x + kSide, kFrom.z + (kTo.z - kFrom.z) / 3.0f, false);
+	}
+
+	// Checkpoints: the start line, then two thirds of the way along every lane. They are written in race order.
+	writer.Write(kCheckpointObject, kStartX, kStartCheckpointZ, false);
+	size_t checkpoints = 1;
+	for (size_t i = 1; i < kCornerCount; i++)
+	{
+		const SPoint& kFrom = kCorners[i];
+		const SPoint& kTo = kCorners[(i + 1) % kCornerCount];
+		if (kFrom.x == kTo.x && fabsf(kTo.z - kFrom.z) >= kMinLaneLength)
+		{
+			writer.Write(kCheckpointObject, kFrom.x, kFrom.z + (kTo.z - kFrom.z) * 2.0f / 3.0f, false);
+			checkpoints++;
+		}
+	}
+
+	// Waypoints along the middle of the road, including every corner, for the enemy to follow
+	vector<SPoint> waypoints;
+	for (size_t i = 0; i < kCornerCount; i++)
+	{
+		const SPoint& kFrom = kCorners[i];
+		const SPoint& kTo = kCorners[(i + 1) % kCornerCount];
+		const float kLength = fabsf(kTo.x - kFrom.x) + fabsf(kTo.z - kFrom.z);
+		const size_t kSteps = max<size_t>(1, static_cast<size_t>(kLength / kWaypointSpacing));
+		for (size_t step = 0; step < kSteps; step++)
+		{
+			const float kFraction = static_cast<float>(step) / kSteps;
+			waypoints.push_back({ kFrom.x + (kTo.x - kFrom.x) * kFraction, kFrom.z + (kTo.z - kFrom.z) * kFraction });
+		}
+	}
+	// The enemy heads for the first waypoint, so start with the first one in front of the start position
+	const auto kFirstWaypoint = find_if(waypoints.begin(), waypoints.end(), [](const SPoint& kWaypoint) { return kWaypoint.z >= kStartZ; });
+	rotate(waypoints.begin(), kFirstWaypoint, waypoints.end());
+	for (const SPoint& kWaypoint : waypoints)
+	{
+		writer.Write(kWaypointObject, kWaypoint.x, kWaypoint.z, false);
+	}
+
+	if (!writer.Succeeded())
+	{
+		cout << "ERROR: Could not write " << kOutputFile << endl;
+		return CodeFileFail;
+	}
+	cout << "Wrote " << kOutputFile << ": " << writer.GetObjectCount() << " objects, " << writer.GetPieceCount() << " isles and walls, " << lanes << " lanes, " << checkpoints << " checkpoints, " << waypoints.size() << " waypoints." << endl;
+	return CodeSuccess;
+}
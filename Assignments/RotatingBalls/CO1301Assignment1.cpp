@@ -39,14 +39,14 @@ constexpr int kY = 1;
 constexpr int kZ = 2;
 
 // enum storing the 2 possible pause states.
-const enum class ePauseState
+enum class ePauseState
 {
 	paused = true,
 	unpaused = false
 };
 
 // enum storing the 2 possible ball directions (clockwise/anticlockwise)
-const enum class eBallDirection
+enum class eBallDirection
 {
 	anticlockwise = false,
 	clockwise = true
@@ -60,7 +60,7 @@ ChangeSkinsKey = Key_E,
 PauseKey = Key_P,
 ExitKey = Key_Escape;
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it. Can be marked as not_null with the gsl library.
 	I3DEngine* myEngine = New3DEngine(kTLX);
@@ -0,0 +1,1114 @@
+// Headless TL-Engine
+//
+// Drop-in replacement for <TL-Engine.h> covering the subset of the API used by the assignments and the weekly labs.
+// Nothing is rendered: every scene node keeps its transform in a plain 4x4 float array, input comes from a frame-based
+// script and Timer() runs off a virtual clock. Put this folder on the include path instead of the TL-Engine one to
+// build and profile the real game loops on Linux.
+//
+// Runtime configuration (read by New3DEngine):
+//   TLE_HEADLESS_FRAMETIME  Seconds returned by Timer() for every frame. Default 1/60.
+//   TLE_HEADLESS_FRAMES     IsRunning() returns false after this many frames. 0 or unset = run until Stop().
+//   TLE_HEADLESS_SCRIPT     Path to an input script, see LoadInputScript().
+//   TLE_HEADLESS_STATS      When set, print frame and tick rate statistics to stderr on Delete().
+
+#pragma once
+#include <string> // String class
+#include <vector> // Vector class
+#include <memory> // unique_ptr owning every engine object
+#include <cmath> // sinf, cosf, sqrtf
+#include <cfloat> // FLT_EPSILON, which the games get through the real engine header
+#include <climits> // INT_MAX
+#include <cstdlib> // getenv, exit, rand
+#include <cstdint> // uint32_t
+#include <cctype> // Key name parsing
+#include <stdexcept> // invalid_argument, out_of_range
+#include <iterator> // begin, end
+#include <limits> // numeric_limits
+#include <algorithm> // sort
+#include <chrono> // Wall clock used for the statistics only
+#include <fstream> // Input scripts
+#include <sstream> // Input script lines
+#include <iostream> // Statistics and script errors
+#include <unordered_map> // Key name lookup
+
+namespace tle
+{
+	// The real engine header exposes the standard library through tle, and the games rely on it.
+	using namespace std;
+
+	enum EEngineType
+	{
+		kTLX,
+		kIrrlicht
+	};
+
+	enum ECameraType
+	{
+		kManual,
+		kFPS
+	};
+
+	// Key codes match the Windows virtual key codes used by the real engine, so casting raw codes keeps working.
+	enum EKeyCode
+	{
+		Mouse_LButton = 0x01, Mouse_RButton = 0x02, Mouse_MButton = 0x04,
+		Key_Back = 0x08, Key_Tab = 0x09, Key_Return = 0x0D, Key_Shift = 0x10, Key_Control = 0x11,
+		Key_Pause = 0x13, Key_Capital = 0x14, Key_Escape = 0x1B, Key_Space = 0x20,
+		Key_Prior = 0x21, Key_Next = 0x22, Key_End = 0x23, Key_Home = 0x24,
+		Key_Left = 0x25, Key_Up = 0x26, Key_Right = 0x27, Key_Down = 0x28,
+		Key_Insert = 0x2D, Key_Delete = 0x2E,
+		Key_0 = 0x30, Key_1, Key_2, Key_3, Key_4, Key_5, Key_6, Key_7, Key_8, Key_9,
+		Key_A = 0x41, Key_B, Key_C, Key_D, Key_E, Key_F, Key_G, Key_H, Key_I, Key_J, Key_K, Key_L, Key_M,
+		Key_N, Key_O, Key_P, Key_Q, Key_R, Key_S, Key_T, Key_U, Key_V, Key_W, Key_X, Key_Y, Key_Z,
+		Key_Numpad0 = 0x60, Key_Numpad1, Key_Numpad2, Key_Numpad3, Key_Numpad4,
+		Key_Numpad5, Key_Numpad6, Key_Numpad7, Key_Numpad8, Key_Numpad9,
+		Key_F1 = 0x70, Key_F2, Key_F3, Key_F4, Key_F5, Key_F6, Key_F7, Key_F8, Key_F9, Key_F10, Key_F11, Key_F12,
+
+		kMaxKeyCodes = 256
+	};
+
+	enum EColour : uint32_t
+	{
+		kBlack = 0xFF000000,
+		kWhite = 0xFFFFFFFF,
+		kRed = 0xFFFF0000,
+		kGreen = 0xFF00FF00,
+		kBlue = 0xFF0000FF,
+		kYellow = 0xFFFFFF00,
+		kCyan = 0xFF00FFFF,
+		kMagenta = 0xFFFF00FF,
+		kGrey = 0xFF808080
+	};
+
+	enum EHorizAlignment
+	{
+		kLeft,
+		kCentre,
+		kRight
+	};
+
+	enum EVertAlignment
+	{
+		kTop,
+		kVCentre,
+		kBottom
+	};
+
+	// Matrix layout shared with the real engine: four rows of four floats, rows are the local X, Y and Z axes and the
+	// position. Points are row vectors, so a child's world matrix is its local matrix multiplied by the parent's.
+	constexpr int kMatrixRows = 4;
+	constexpr int kMatrixElements = kMatrixRows * kMatrixRows;
+	constexpr int kPositionRow = 3;
+	constexpr float kDegreesToRadians = 3.14159265358979323846f / 180.0f;
+
+	class ISceneNode
+	{
+	protected:
+		float matrix_[kMatrixElements]{ 1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f };
+		ISceneNode* parent_ = nullptr;
+
+		static void Multiply(const float* kA, const float* kB, float* result) noexcept
+		{
+			for (int row = 0; row < kMatrixRows; row++)
+			{
+				for (int column = 0; column < kMatrixRows; column++)
+				{
+					float sum = 0.0f;
+					for (int i = 0; i < kMatrixRows; i++)
+					{
+						sum += kA[row * kMatrixRows + i] * kB[i * kMatrixRows + column];
+					}
+					result[row * kMatrixRows + column] = sum;
+				}
+			}
+		}
+
+		float AxisLength(const int& kRow) const noexcept
+		{
+			const float* kAxis = matrix_ + kRow * kMatrixRows;
+			return sqrtf(kAxis[0] * kAxis[0] + kAxis[1] * kAxis[1] + kAxis[2] * kAxis[2]);
+		}
+
+		// Rotate the three axis rows about one of the parent's axes (0 = X, 1 = Y, 2 = Z).
+		void RotateAxes(const int& kAxis, const float& kDegrees) noexcept
+		{
+			const float kSin = sinf(kDegrees * kDegreesToRadians);
+			const float kCos = cosf(kDegrees * kDegreesToRadians);
+			const int kA = (kAxis + 1) % 3;
+			const int kB = (kAxis + 2) % 3;
+			for (int row = 0; row < 3; row++)
+			{
+				float* axis = matrix_ + row * kMatrixRows;
+				const float kOldA = axis[kA];
+				const float kOldB = axis[kB];
+				axis[kA] = kOldA * kCos - kOldB * kSin;
+				axis[kB] = kOldA * kSin + kOldB * kCos;
+			}
+		}
+
+		// Rotate the node about one of its own axes (0 = X, 1 = Y, 2 = Z).
+		void RotateLocalAxes(const int& kAxis, const float& kDegrees) noexcept
+		{
+			const float kSin = sinf(kDegrees * kDegreesToRadians);
+			const float kCos = cosf(kDegrees * kDegreesToRadians);
+			float* rowA = matrix_ + ((kAxis + 1) % 3) * kMatrixRows;
+			float* rowB = matrix_ + ((kAxis + 2) % 3) * kMatrixRows;
+			for (int i = 0; i < 3; i++)
+			{
+				const float kOldA = rowA[i];
+				const float kOldB = rowB[i];
+				rowA[i] = kOldA * kCos + kOldB * kSin;
+				rowB[i] = -kOldA * kSin + kOldB * kCos;
+			}
+		}
+
+		void MoveAlongAxis(const int& kRow, const float& kDistance) noexcept
+		{
+			const float kLength = AxisLength(kRow);
+			if (kLength <= FLT_EPSILON)
+			{
+				return;
+			}
+			const float* kAxis = matrix_ + kRow * kMatrixRows;
+			for (int i = 0; i < 3; i++)
+			{
+				matrix_[kPositionRow * kMatrixRows + i] += kAxis[i] / kLength * kDistance;
+			}
+		}
+
+		void ScaleAxis(const int& kRow, const float& kScale) noexcept
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				matrix_[kRow * kMatrixRows + i] *= kScale;
+			}
+		}
+
+	public:
+		virtual ~ISceneNode() = default;
+
+		// Write the world matrix of this node to the 16 floats pointed to by parameter.
+		void GetMatrix(float* matrix) const noexcept
+		{
+			if (parent_ == nullptr)
+			{
+				copy(begin(matrix_), end(matrix_), matrix);
+				return;
+			}
+			float parentMatrix[kMatrixElements];
+			parent_->GetMatrix(parentMatrix);
+			Multiply(matrix_, parentMatrix, matrix);
+		}
+		// Replace the matrix relative to the parent (or the world when unattached).
+		void SetMatrix(const float* kMatrix) noexcept
+		{
+			copy(kMatrix, kMatrix + kMatrixElements, begin(matrix_));
+		}
+		// Direct access to the parent relative matrix. Headless only.
+		const float* GetLocalMatrix() const noexcept
+		{
+			return matrix_;
+		}
+
+		// World position.
+		float GetX() const noexcept
+		{
+			return (parent_ == nullptr) ? matrix_[12] : WorldPosition(0);
+		}
+		float GetY() const noexcept
+		{
+			return (parent_ == nullptr) ? matrix_[13] : WorldPosition(1);
+		}
+		float GetZ() const noexcept
+		{
+			return (parent_ == nullptr) ? matrix_[14] : WorldPosition(2);
+		}
+		float WorldPosition(const int& kComponent) const noexcept
+		{
+			float world[kMatrixElements];
+			GetMatrix(world);
+			return world[kPositionRow * kMatrixRows + kComponent];
+		}
+
+		// Position relative to the parent.
+		float GetLocalX() const noexcept
+		{
+			return matrix_[12];
+		}
+		float GetLocalY() const noexcept
+		{
+			return matrix_[13];
+		}
+		float GetLocalZ() const noexcept
+		{
+			return matrix_[14];
+		}
+
+		// Setters and movement work relative to the parent, which is the world for unattached nodes.
+		void SetX(const float x) noexcept
+		{
+			matrix_[12] = x;
+		}
+		void SetY(const float y) noexcept
+		{
+			matrix_[13] = y;
+		}
+		void SetZ(const float z) noexcept
+		{
+			matrix_[14] = z;
+		}
+		void SetPosition(const float x, const float y, const float z) noexcept
+		{
+			matrix_[12] = x;
+			matrix_[13] = y;
+			matrix_[14] = z;
+		}
+		void SetLocalX(const float x) noexcept
+		{
+			matrix_[12] = x;
+		}
+		void SetLocalY(const float y) noexcept
+		{
+			matrix_[13] = y;
+		}
+		void SetLocalZ(const float z) noexcept
+		{
+			matrix_[14] = z;
+		}
+		void SetLocalPosition(const float x, const float y, const float z) noexcept
+		{
+			SetPosition(x, y, z);
+		}
+		void Move(const float x, const float y, const float z) noexcept
+		{
+			matrix_[12] += x;
+			matrix_[13] += y;
+			matrix_[14] += z;
+		}
+		void MoveX(const float x) noexcept
+		{
+			matrix_[12] += x;
+		}
+		void MoveY(const float y) noexcept
+		{
+			matrix_[13] += y;
+		}
+		void MoveZ(const float z) noexcept
+		{
+			matrix_[14] += z;
+		}
+		void MoveLocal(const float x, const float y, const float z) noexcept
+		{
+			MoveAlongAxis(0, x);
+			MoveAlongAxis(1, y);
+			MoveAlongAxis(2, z);
+		}
+		void MoveLocalX(const float x) noexcept
+		{
+			MoveAlongAxis(0, x);
+		}
+		void MoveLocalY(const float y) noexcept
+		{
+			MoveAlongAxis(1, y);
+		}
+		void MoveLocalZ(const float z) noexcept
+		{
+			MoveAlongAxis(2, z);
+		}
+
+		// Rotations are in degrees, positive values are clockwise when looking along the axis (left-handed).
+		void RotateX(const float degrees) noexcept
+		{
+			RotateAxes(0, degrees);
+		}
+		void RotateY(const float degrees) noexcept
+		{
+			RotateAxes(1, degrees);
+		}
+		void RotateZ(const float degrees) noexcept
+		{
+			RotateAxes(2, degrees);
+		}
+		void RotateLocalX(const float degrees) noexcept
+		{
+			RotateLocalAxes(0, degrees);
+		}
+		void RotateLocalY(const float degrees) noexcept
+		{
+			RotateLocalAxes(1, degrees);
+		}
+		void RotateLocalZ(const float degrees) noexcept
+		{
+			RotateLocalAxes(2, degrees);
+		}
+		// Remove any rotation, keeping the current scale.
+		void ResetOrientation() noexcept
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				const float kScale = AxisLength(row);
+				for (int i = 0; i < 3; i++)
+				{
+					matrix_[row * kMatrixRows + i] = (row == i) ? kScale : 0.0f;
+				}
+			}
+		}
+
+		void Scale(const float scale) noexcept
+		{
+			ScaleAxis(0, scale);
+			ScaleAxis(1, scale);
+			ScaleAxis(2, scale);
+		}
+		void ScaleX(const float scale) noexcept
+		{
+			ScaleAxis(0, scale);
+		}
+		void ScaleY(const float scale) noexcept
+		{
+			ScaleAxis(1, scale);
+		}
+		void ScaleZ(const float scale) noexcept
+		{
+			ScaleAxis(2, scale);
+		}
+		void ResetScale() noexcept
+		{
+			for (int row = 0; row < 3; row++)
+			{
+				const float kLength = AxisLength(row);
+				if (kLength > FLT_EPSILON)
+				{
+					ScaleAxis(row, 1.0f / kLength);
+				}
+			}
+		}
+
+		// Face the world position given, keeping the world Y axis up and the current scale.
+		void LookAt(const float x, const float y, const float z) noexcept
+		{
+			float forward[3]{ x - GetX(), y - GetY(), z - GetZ() };
+			const float kForwardLength = sqrtf(forward[0] * forward[0] + forward[1] * forward[1] + forward[2] * forward[2]);
+			if (kForwardLength <= FLT_EPSILON)
+			{
+				return;
+			}
+			for (float& component : forward)
+			{
+				component /= kForwardLength;
+			}
+			// right = up x forward, using the world up unless looking straight up or down.
+			float right[3]{ forward[2], 0.0f, -forward[0] };
+			float rightLength = sqrtf(right[0] * right[0] + right[2] * right[2]);
+			if (rightLength <= FLT_EPSILON)
+			{
+				right[0] = 1.0f;
+				right[2] = 0.0f;
+				rightLength = 1.0f;
+			}
+			right[0] /= rightLength;
+			right[2] /= rightLength;
+			const float kUp[3]{ forward[1] * right[2] - forward[2] * right[1], forward[2] * right[0] - forward[0] * right[2], forward[0] * right[1] - forward[1] * right[0] };
+
+			const float kScales[3]{ AxisLength(0), AxisLength(1), AxisLength(2) };
+			for (int i = 0; i < 3; i++)
+			{
+				matrix_[0 * kMatrixRows + i] = right[i] * kScales[0];
+				matrix_[1 * kMatrixRows + i] = kUp[i] * kScales[1];
+				matrix_[2 * kMatrixRows + i] = forward[i] * kScales[2];
+			}
+		}
+		void LookAt(const ISceneNode* kTarget) noexcept
+		{
+			LookAt(kTarget->GetX(), kTarget->GetY(), kTarget->GetZ());
+		}
+
+		// The current matrix becomes relative to the new parent, as in the real engine.
+		void AttachToParent(ISceneNode* parent) noexcept
+		{
+			parent_ = parent;
+		}
+		// Keep the node where it is in the world when it is detached.
+		void DetachFromParent() noexcept
+		{
+			if (parent_ == nullptr)
+			{
+				return;
+			}
+			float world[kMatrixElements];
+			GetMatrix(world);
+			parent_ = nullptr;
+			SetMatrix(world);
+		}
+		ISceneNode* GetParent() const noexcept
+		{
+			return parent_;
+		}
+	};
+
+	class IMesh;
+
+	class IModel : public ISceneNode
+	{
+	private:
+		friend class IMesh;
+		IMesh* mesh_ = nullptr;
+		size_t meshIndex_ = 0; // Position inside the owning mesh, so RemoveModel is constant time.
+		vector<unique_ptr<ISceneNode>> nodes_;
+		string skin_;
+
+	public:
+		// Sub-nodes are created on first use and attached to the model.
+		ISceneNode* GetNode(const int& kNode)
+		{
+			while (nodes_.size() <= static_cast<size_t>(kNode))
+			{
+				nodes_.push_back(make_unique<ISceneNode>());
+				nodes_.back()->AttachToParent(this);
+			}
+			return nodes_.at(kNode).get();
+		}
+		int GetNumNodes() const noexcept
+		{
+			return static_cast<int>(nodes_.size());
+		}
+		void SetSkin(const string& kSkin, const int& kSkinIndex = 0)
+		{
+			if (kSkinIndex == 0)
+			{
+				skin_ = kSkin;
+			}
+		}
+		const string& GetSkin() const noexcept
+		{
+			return skin_;
+		}
+		IMesh* GetMesh() const noexcept
+		{
+			return mesh_;
+		}
+	};
+
+	class IMesh
+	{
+	private:
+		string fileName_;
+		vector<unique_ptr<IModel>> models_;
+
+	public:
+		explicit IMesh(const string& kFileName) : fileName_(kFileName)
+		{
+		}
+		IModel* CreateModel(const float x = 0.0f, const float y = 0.0f, const float z = 0.0f)
+		{
+			models_.push_back(make_unique<IModel>());
+			IModel* model = models_.back().get();
+			model->mesh_ = this;
+			model->meshIndex_ = models_.size() - 1;
+			model->SetPosition(x, y, z);
+			return model;
+		}
+		void RemoveModel(IModel* model)
+		{
+			if (model == nullptr || model->mesh_ != this)
+			{
+				return;
+			}
+			const size_t kIndex = model->meshIndex_;
+			if (kIndex != models_.size() - 1)
+			{
+				swap(models_.at(kIndex), models_.back());
+				models_.at(kIndex)->meshIndex_ = kIndex;
+			}
+			models_.pop_back();
+		}
+		const string& GetFileName() const noexcept
+		{
+			return fileName_;
+		}
+		size_t GetNumModels() const noexcept
+		{
+			return models_.size();
+		}
+	};
+
+	class ICamera : public ISceneNode
+	{
+	private:
+		ECameraType type_ = kManual;
+		float nearClip_ = 1.0f;
+		float farClip_ = 10000.0f;
+		float fov_ = 60.0f;
+
+	public:
+		explicit ICamera(const ECameraType& kType) noexcept : type_(kType)
+		{
+		}
+		ECameraType GetType() const noexcept
+		{
+			return type_;
+		}
+		void SetNearClip(const float nearClip) noexcept
+		{
+			nearClip_ = nearClip;
+		}
+		void SetFarClip(const float farClip) noexcept
+		{
+			farClip_ = farClip;
+		}
+		void SetFOV(const float fov) noexcept
+		{
+			fov_ = fov;
+		}
+		void SetMovementSpeed(const float) noexcept
+		{
+		}
+		void SetRotationSpeed(const float) noexcept
+		{
+		}
+	};
+
+	class IFont
+	{
+	private:
+		string name_;
+		unsigned int size_ = 36;
+		size_t draws_ = 0; // How many strings were drawn since the font was loaded.
+		string lastText_;
+
+	public:
+		IFont(const string& kName, const unsigned int& kSize) : name_(kName), size_(kSize)
+		{
+		}
+		void Draw(const string& kText, const int, const int, const EColour = kBlack, const EHorizAlignment = kLeft, const EVertAlignment = kTop)
+		{
+			draws_++;
+			lastText_ = kText;
+		}
+		unsigned int MeasureTextWidth(const string& kText) const noexcept
+		{
+			return static_cast<unsigned int>(kText.size()) * size_ / 2;
+		}
+		unsigned int MeasureTextHeight(const string&) const noexcept
+		{
+			return size_;
+		}
+		size_t GetDrawCount() const noexcept
+		{
+			return draws_;
+		}
+		const string& GetLastText() const noexcept
+		{
+			return lastText_;
+		}
+	};
+
+	class ISprite
+	{
+	private:
+		string fileName_;
+		float position_[3]{ 0.0f, 0.0f, 0.0f };
+
+	public:
+		ISprite(const string& kFileName, const float x, const float y, const float z) : fileName_(kFileName), position_{ x, y, z }
+		{
+		}
+		float GetX() const noexcept
+		{
+			return position_[0];
+		}
+		float GetY() const noexcept
+		{
+			return position_[1];
+		}
+		float GetZ() const noexcept
+		{
+			return position_[2];
+		}
+		void SetX(const float x) noexcept
+		{
+			position_[0] = x;
+		}
+		void SetY(const float y) noexcept
+		{
+			position_[1] = y;
+		}
+		void SetZ(const float z) noexcept
+		{
+			position_[2] = z;
+		}
+		void SetPosition(const float x, const float y) noexcept
+		{
+			position_[0] = x;
+			position_[1] = y;
+		}
+		void MoveX(const float x) noexcept
+		{
+			position_[0] += x;
+		}
+		void MoveY(const float y) noexcept
+		{
+			position_[1] += y;
+		}
+		void MoveZ(const float z) noexcept
+		{
+			position_[2] += z;
+		}
+	};
+
+	// One scripted input change, applied when DrawScene() starts the given frame.
+	struct SHeadlessInputEvent
+	{
+		enum EType
+		{
+			keyDown,
+			keyUp,
+			mouseMove,
+			wheelMove,
+			stop
+		};
+
+		unsigned long long frame;
+		EType type;
+		int key;
+		int x;
+		int y;
+	};
+
+	class I3DEngine
+	{
+	private:
+		bool running_ = false;
+		bool mouseCaptured_ = false;
+		int width_ = 1280;
+		int height_ = 960;
+		vector<string> mediaFolders_;
+		vector<unique_ptr<IMesh>> meshes_;
+		vector<unique_ptr<ICamera>> cameras_;
+		vector<unique_ptr<IFont>> fonts_;
+		vector<unique_ptr<ISprite>> sprites_;
+
+		// Virtual clock
+		float frameTime_ = 1.0f / 60.0f;
+		double virtualTime_ = 0.0; // Seconds of simulated time since the engine started.
+		double lastTimerCall_ = 0.0;
+		unsigned long long frame_ = 0;
+		unsigned long long frameLimit_ = 0; // 0 = unlimited
+		chrono::steady_clock::time_point wallStart_ = chrono::steady_clock::now();
+		bool printStats_ = false;
+
+		// Scripted input
+		vector<SHeadlessInputEvent> events_;
+		size_t nextEvent_ = 0;
+		bool eventsSorted_ = true;
+		bool keyHeld_[kMaxKeyCodes]{ false };
+		bool keyHit_[kMaxKeyCodes]{ false };
+		int mouseMovementX_ = 0;
+		int mouseMovementY_ = 0;
+		int mouseWheelMovement_ = 0;
+		int mouseX_ = 0;
+		int mouseY_ = 0;
+
+		static int KeyFromName(const string& kName)
+		{
+			static const unordered_map<string, int> kNamedKeys{
+				{ "LButton", Mouse_LButton }, { "RButton", Mouse_RButton }, { "MButton", Mouse_MButton },
+				{ "Back", Key_Back }, { "Tab", Key_Tab }, { "Return", Key_Return }, { "Shift", Key_Shift },
+				{ "Control", Key_Control }, { "Escape", Key_Escape }, { "Space", Key_Space },
+				{ "Left", Key_Left }, { "Up", Key_Up }, { "Right", Key_Right }, { "Down", Key_Down },
+				{ "Insert", Key_Insert }, { "Delete", Key_Delete }, { "Home", Key_Home }, { "End", Key_End }
+			};
+			const auto kFound = kNamedKeys.find(kName);
+			if (kFound != kNamedKeys.end())
+			{
+				return kFound->second;
+			}
+			// Single letters and digits map to their character code, anything else must be a number.
+			if (kName.size() == 1 && (isalpha(static_cast<unsigned char>(kName[0])) || isdigit(static_cast<unsigned char>(kName[0]))))
+			{
+				return toupper(static_cast<unsigned char>(kName[0]));
+			}
+			size_t end = 0;
+			const int kCode = stoi(kName, &end, 0);
+			// Key codes index the key state arrays, so anything outside them is a mistake in the script
+			if (end != kName.size() || kCode < 0 || kCode >= kMaxKeyCodes)
+			{
+				throw out_of_range(kName);
+			}
+			return kCode;
+		}
+
+		void ApplyEvents()
+		{
+			if (!eventsSorted_)
+			{
+				stable_sort(events_.begin() + nextEvent_, events_.end(), [](const SHeadlessInputEvent& kA, const SHeadlessInputEvent& kB) { return kA.frame < kB.frame; });
+				eventsSorted_ = true;
+			}
+			while (nextEvent_ < events_.size() && events_[nextEvent_].frame <= frame_)
+			{
+				const SHeadlessInputEvent& kEvent = events_[nextEvent_++];
+				switch (kEvent.type)
+				{
+				case SHeadlessInputEvent::keyDown:
+					if (!keyHeld_[kEvent.key])
+					{
+						keyHit_[kEvent.key] = true;
+					}
+					keyHeld_[kEvent.key] = true;
+					break;
+				case SHeadlessInputEvent::keyUp:
+					keyHeld_[kEvent.key] = false;
+					break;
+				case SHeadlessInputEvent::mouseMove:
+					mouseMovementX_ += kEvent.x;
+					mouseMovementY_ += kEvent.y;
+					mouseX_ += kEvent.x;
+					mouseY_ += kEvent.y;
+					break;
+				case SHeadlessInputEvent::wheelMove:
+					mouseWheelMovement_ += kEvent.x;
+					break;
+				case SHeadlessInputEvent::stop:
+					running_ = false;
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		void PushEvent(const SHeadlessInputEvent& kEvent)
+		{
+			if (!events_.empty() && kEvent.frame < events_.back().frame)
+			{
+				eventsSorted_ = false;
+			}
+			events_.push_back(kEvent);
+		}
+
+	public:
+		I3DEngine()
+		{
+			if (const char* kFrameTime = getenv("TLE_HEADLESS_FRAMETIME"))
+			{
+				frameTime_ = strtof(kFrameTime, nullptr);
+			}
+			if (const char* kFrames = getenv("TLE_HEADLESS_FRAMES"))
+			{
+				frameLimit_ = strtoull(kFrames, nullptr, 10);
+			}
+			if (const char* kScript = getenv("TLE_HEADLESS_SCRIPT"))
+			{
+				LoadInputScript(kScript);
+			}
+			printStats_ = getenv("TLE_HEADLESS_STATS") != nullptr;
+		}
+
+		// Window management
+		void StartWindowed(const int width = 1280, const int height = 960) noexcept
+		{
+			width_ = width;
+			height_ = height;
+			running_ = true;
+			wallStart_ = chrono::steady_clock::now();
+		}
+		void StartFullscreen(const int width = 1280, const int height = 960) noexcept
+		{
+			StartWindowed(width, height);
+		}
+		bool IsRunning() noexcept
+		{
+			if (frameLimit_ != 0 && frame_ >= frameLimit_)
+			{
+				running_ = false;
+			}
+			return running_;
+		}
+		void Stop() noexcept
+		{
+			running_ = false;
+		}
+		void Delete()
+		{
+			if (printStats_)
+			{
+				const double kWallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart_).count();
+				size_t models = 0;
+				for (const auto& kMesh : meshes_)
+				{
+					models += kMesh->GetNumModels();
+				}
+				cerr << "[headless] frames: " << frame_ << ", virtual time: " << virtualTime_ << "s, wall time: " << kWallSeconds << "s, "
+					<< (kWallSeconds > 0.0 ? frame_ / kWallSeconds : 0.0) << " ticks/s, meshes: " << meshes_.size() << ", models: " << models << endl;
+			}
+			delete this;
+		}
+		void SetWindowCaption(const string&) noexcept
+		{
+		}
+		int GetWidth() const noexcept
+		{
+			return width_;
+		}
+		int GetHeight() const noexcept
+		{
+			return height_;
+		}
+
+		// Media
+		void AddMediaFolder(const string& kFolder)
+		{
+			mediaFolders_.push_back(kFolder);
+		}
+		void ClearMediaFolders() noexcept
+		{
+			mediaFolders_.clear();
+		}
+		const vector<string>& GetMediaFolders() const noexcept
+		{
+			return mediaFolders_;
+		}
+		// Nothing is read from disk; every call returns a new mesh just like the real engine.
+		IMesh* LoadMesh(const string& kFileName)
+		{
+			meshes_.push_back(make_unique<IMesh>(kFileName));
+			return meshes_.back().get();
+		}
+		void RemoveMesh(IMesh* mesh)
+		{
+			meshes_.erase(remove_if(meshes_.begin(), meshes_.end(), [mesh](const unique_ptr<IMesh>& kMesh) { return kMesh.get() == mesh; }), meshes_.end());
+		}
+		ICamera* CreateCamera(const ECameraType type = kFPS, const float x = 0.0f, const float y = 0.0f, const float z = 0.0f)
+		{
+			cameras_.push_back(make_unique<ICamera>(type));
+			cameras_.back()->SetPosition(x, y, z);
+			return cameras_.back().get();
+		}
+		void RemoveCamera(ICamera* camera)
+		{
+			cameras_.erase(remove_if(cameras_.begin(), cameras_.end(), [camera](const unique_ptr<ICamera>& kCamera) { return kCamera.get() == camera; }), cameras_.end());
+		}
+		IFont* LoadFont(const string& kFontName, const unsigned int fontSize = 36)
+		{
+			fonts_.push_back(make_unique<IFont>(kFontName, fontSize));
+			return fonts_.back().get();
+		}
+		void RemoveFont(IFont* font)
+		{
+			fonts_.erase(remove_if(fonts_.begin(), fonts_.end(), [font](const unique_ptr<IFont>& kFont) { return kFont.get() == font; }), fonts_.end());
+		}
+		ISprite* CreateSprite(const string& kFileName, const float x = 0.0f, const float y = 0.0f, const float z = 0.0f)
+		{
+			sprites_.push_back(make_unique<ISprite>(kFileName, x, y, z));
+			return sprites_.back().get();
+		}
+		void RemoveSprite(ISprite* sprite)
+		{
+			sprites_.erase(remove_if(sprites_.begin(), sprites_.end(), [sprite](const unique_ptr<ISprite>& kSprite) { return kSprite.get() == sprite; }), sprites_.end());
+		}
+
+		// Advance to the next frame: move the virtual clock on and apply the scripted input for it.
+		void DrawScene(ICamera* = nullptr)
+		{
+			frame_++;
+			virtualTime_ += frameTime_;
+			ApplyEvents();
+		}
+		// Seconds of virtual time since the last call.
+		float Timer() noexcept
+		{
+			const float kElapsed = static_cast<float>(virtualTime_ - lastTimerCall_);
+			lastTimerCall_ = virtualTime_;
+			return kElapsed;
+		}
+
+		// Input
+		bool KeyHit(const EKeyCode key) noexcept
+		{
+			const bool kHit = keyHit_[key];
+			keyHit_[key] = false;
+			return kHit;
+		}
+		bool KeyHeld(const EKeyCode key) const noexcept
+		{
+			return keyHeld_[key];
+		}
+		bool AnyKeyHit() noexcept
+		{
+			bool anyHit = false;
+			for (bool& hit : keyHit_)
+			{
+				anyHit = anyHit || hit;
+				hit = false;
+			}
+			return anyHit;
+		}
+		bool AnyKeyHeld() const noexcept
+		{
+			return find(begin(keyHeld_), end(keyHeld_), true) != end(keyHeld_);
+		}
+		int GetMouseX() const noexcept
+		{
+			return mouseX_;
+		}
+		int GetMouseY() const noexcept
+		{
+			return mouseY_;
+		}
+		int GetMouseMovementX() noexcept
+		{
+			const int kMovement = mouseMovementX_;
+			mouseMovementX_ = 0;
+			return kMovement;
+		}
+		int GetMouseMovementY() noexcept
+		{
+			const int kMovement = mouseMovementY_;
+			mouseMovementY_ = 0;
+			return kMovement;
+		}
+		int GetMouseWheelMovement() noexcept
+		{
+			const int kMovement = mouseWheelMovement_;
+			mouseWheelMovement_ = 0;
+			return kMovement;
+		}
+		void StartMouseCapture() noexcept
+		{
+			mouseCaptured_ = true;
+		}
+		void StopMouseCapture() noexcept
+		{
+			mouseCaptured_ = false;
+		}
+		bool IsMouseCaptured() const noexcept
+		{
+			return mouseCaptured_;
+		}
+
+		// Headless control, not part of the real engine.
+
+		void SetFrameTime(const float& kFrameTime) noexcept
+		{
+			frameTime_ = kFrameTime;
+		}
+		void SetFrameLimit(const unsigned long long& kFrames) noexcept
+		{
+			frameLimit_ = kFrames;
+		}
+		unsigned long long GetFrameCount() const noexcept
+		{
+			return frame_;
+		}
+		// Hold a key down from the first frame to the last frame inclusive.
+		void ScriptKey(const unsigned long long& kFirstFrame, const unsigned long long& kLastFrame, const EKeyCode& kKey)
+		{
+			PushEvent({ kFirstFrame, SHeadlessInputEvent::keyDown, kKey, 0, 0 });
+			PushEvent({ kLastFrame + 1, SHeadlessInputEvent::keyUp, kKey, 0, 0 });
+		}
+		void ScriptMouse(const unsigned long long& kFrame, const int& kMovementX, const int& kMovementY)
+		{
+			PushEvent({ kFrame, SHeadlessInputEvent::mouseMove, 0, kMovementX, kMovementY });
+		}
+		void ScriptWheel(const unsigned long long& kFrame, const int& kMovement)
+		{
+			PushEvent({ kFrame, SHeadlessInputEvent::wheelMove, 0, kMovement, 0 });
+		}
+		void ScriptStop(const unsigned long long& kFrame)
+		{
+			PushEvent({ kFrame, SHeadlessInputEvent::stop, 0, 0, 0 });
+		}
+
+		// Read an input script. One command per line, frames start at 1 and '#' starts a comment:
+		//   hold <firstFrame> <lastFrame> <key>   e.g. "hold 1 1 Space", "hold 10 400 W", "hold 50 60 0x41"
+		//   mouse <frame> <dx> <dy>
+		//   wheel <frame> <delta>
+		//   stop <frame>
+		bool LoadInputScript(const string& kFileName)
+		{
+			ifstream inputStream(kFileName);
+			if (!inputStream)
+			{
+				cerr << "[headless] Cannot open input script: " << kFileName << endl;
+				return false;
+			}
+			string line;
+			unsigned int lineIndex = 0;
+			while (getline(inputStream, line))
+			{
+				lineIndex++;
+				const size_t kComment = line.find('#');
+				if (kComment != string::npos)
+				{
+					line.erase(kComment);
+				}
+				istringstream lineStream(line);
+				string command;
+				if (!(lineStream >> command))
+				{
+					continue;
+				}
+				try
+				{
+					if (command == "hold")
+					{
+						unsigned long long first = 0;
+						unsigned long long last = 0;
+						string key;
+						if (!(lineStream >> first >> last >> key))
+						{
+							throw invalid_argument(line);
+						}
+						ScriptKey(first, last, static_cast<EKeyCode>(KeyFromName(key)));
+					}
+					else if (command == "mouse")
+					{
+						unsigned long long frame = 0;
+						int x = 0;
+						int y = 0;
+						if (!(lineStream >> frame >> x >> y))
+						{
+							throw invalid_argument(line);
+						}
+						ScriptMouse(frame, x, y);
+					}
+					else if (command == "wheel")
+					{
+						unsigned long long frame = 0;
+						int movement = 0;
+						if (!(lineStream >> frame >> movement))
+						{
+							throw invalid_argument(line);
+						}
+						ScriptWheel(frame, movement);
+					}
+					else if (command == "stop")
+					{
+						unsigned long long frame = 0;
+						if (!(lineStream >> frame))
+						{
+							throw invalid_argument(line);
+						}
+						ScriptStop(frame);
+					}
+					else
+					{
+						throw invalid_argument(command);
+					}
+				}
+				catch (const exception&)
+				{
+					cerr << "[headless] " << kFileName << ":" << lineIndex << ": cannot parse \"" << line << "\"" << endl;
+					return false;
+				}
+			}
+			return true;
+		}
+	};
+
+	inline I3DEngine* New3DEngine(const EEngineType)
+	{
+		return new I3DEngine();
+	}
+}
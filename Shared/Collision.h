@@ -0,0 +1,211 @@
+#pragma once
+#include <cstddef> // size_t
+#include <cstdint> // Fixed width integers for hit masks
+
+// Shared collision tests
+// Collision between simple shapes on the ground plane (x and z), shared by the games so a faster test lands in all of
+// them at once. Nothing here uses TL-Engine: a game copies the positions out of its models into the shapes below.
+// The test for a pair of shapes is picked at compile time, from the SCollisionTest specialisations. Pairs can be given
+// either way round, and a pair with no test is a compile error rather than a silent false.
+// Every test uses strict comparisons, so shapes that only touch have not collided.
+
+// A point
+struct SPointShape
+{
+	float x;
+	float z;
+};
+
+// A sphere, tested as the circle it makes on the ground
+struct SSphereShape
+{
+	float x;
+	float z;
+	float radius;
+};
+
+// A box lined up with the x and z axes
+struct SBoxShape
+{
+	float x;
+	float z;
+	float halfWidth; // Half the size along the x axis
+	float halfLength; // Half the size along the z axis
+};
+
+// A box turned about the y axis
+struct SOrientedBoxShape
+{
+	float x;
+	float z;
+	float halfWidth; // Half the size along the box's own x axis
+	float halfLength; // Half the size along the box's own z axis
+	float axisX; // The box's own x axis, as a unit vector. 1, 0 for a box that isn't turned.
+	float axisZ;
+};
+
+// Turn a position into a box's own axes, given the box's x axis. The box's z axis is the x axis turned a right angle.
+constexpr float GetShapeLocalX(const float& kAxisX, const float& kAxisZ, const float& kX, const float& kZ) noexcept
+{
+	return kX * kAxisX + kZ * kAxisZ;
+}
+constexpr float GetShapeLocalZ(const float& kAxisX, const float& kAxisZ, const float& kX, const float& kZ) noexcept
+{
+	return kZ * kAxisX - kX * kAxisZ;
+}
+
+// The test for a pair of shapes. Only the pairs specialised below have one.
+template <typename FirstShape, typename SecondShape>
+struct SCollisionTest
+{
+	static constexpr bool kDefined = false;
+};
+
+template <>
+struct SCollisionTest<SSphereShape, SSphereShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SSphereShape& kFirst, const SSphereShape& kSecond) noexcept
+	{
+		const float kDistanceX = kSecond.x - kFirst.x;
+		const float kDistanceZ = kSecond.z - kFirst.z;
+		const float kReach = kFirst.radius + kSecond.radius;
+		return kDistanceX * kDistanceX + kDistanceZ * kDistanceZ < kReach * kReach;
+	}
+};
+
+template <>
+struct SCollisionTest<SPointShape, SSphereShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SPointShape& kPoint, const SSphereShape& kSphere) noexcept
+	{
+		return SCollisionTest<SSphereShape, SSphereShape>::IsCollided({ kPoint.x, kPoint.z, 0.0f }, kSphere);
+	}
+};
+
+template <>
+struct SCollisionTest<SPointShape, SBoxShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SPointShape& kPoint, const SBoxShape& kBox) noexcept
+	{
+		return kPoint.z > kBox.z - kBox.halfLength && kPoint.z < kBox.z + kBox.halfLength
+			&& kPoint.x > kBox.x - kBox.halfWidth && kPoint.x < kBox.x + kBox.halfWidth;
+	}
+};
+
+// The box is grown by the sphere's radius, so a sphere just off a corner still counts as inside. The games have always
+// collided this way, and the batch kernels give the same answers.
+template <>
+struct SCollisionTest<SSphereShape, SBoxShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SSphereShape& kSphere, const SBoxShape& kBox) noexcept
+	{
+		return kSphere.x < kBox.x + kBox.halfWidth + kSphere.radius && kSphere.x > kBox.x - kBox.halfWidth - kSphere.radius
+			&& kSphere.z < kBox.z + kBox.halfLength + kSphere.radius && kSphere.z > kBox.z - kBox.halfLength - kSphere.radius;
+	}
+};
+
+template <>
+struct SCollisionTest<SBoxShape, SBoxShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SBoxShape& kFirst, const SBoxShape& kSecond) noexcept
+	{
+		return SCollisionTest<SPointShape, SBoxShape>::IsCollided({ kFirst.x, kFirst.z },
+			{ kSecond.x, kSecond.z, kSecond.halfWidth + kFirst.halfWidth, kSecond.halfLength + kFirst.halfLength });
+	}
+};
+
+// Turned boxes are tested in their own axes, as a box lined up with them
+template <>
+struct SCollisionTest<SPointShape, SOrientedBoxShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SPointShape& kPoint, const SOrientedBoxShape& kBox) noexcept
+	{
+		return SCollisionTest<SPointShape, SBoxShape>::IsCollided(
+			{ GetShapeLocalX(kBox.axisX, kBox.axisZ, kPoint.x, kPoint.z), GetShapeLocalZ(kBox.axisX, kBox.axisZ, kPoint.x, kPoint.z) },
+			{ GetShapeLocalX(kBox.axisX, kBox.axisZ, kBox.x, kBox.z), GetShapeLocalZ(kBox.axisX, kBox.axisZ, kBox.x, kBox.z), kBox.halfWidth, kBox.halfLength });
+	}
+};
+
+template <>
+struct SCollisionTest<SSphereShape, SOrientedBoxShape>
+{
+	static constexpr bool kDefined = true;
+	static constexpr bool IsCollided(const SSphereShape& kSphere, const SOrientedBoxShape& kBox) noexcept
+	{
+		return SCollisionTest<SSphereShape, SBoxShape>::IsCollided(
+			{ GetShapeLocalX(kBox.axisX, kBox.axisZ, kSphere.x, kSphere.z), GetShapeLocalZ(kBox.axisX, kBox.axisZ, kSphere.x, kSphere.z), kSphere.radius },
+			{ GetShapeLocalX(kBox.axisX, kBox.axisZ, kBox.x, kBox.z), GetShapeLocalZ(kBox.axisX, kBox.axisZ, kBox.x, kBox.z), kBox.halfWidth, kBox.halfLength });
+	}
+};
+
+// Check if two shapes have collided
+template <typename FirstShape, typename SecondShape>
+constexpr bool IsCollided(const FirstShape& kFirst, const SecondShape& kSecond) noexcept
+{
+	static_assert(SCollisionTest<FirstShape, SecondShape>::kDefined || SCollisionTest<SecondShape, FirstShape>::kDefined, "There is no collision test for this pair of shapes");
+	if constexpr (SCollisionTest<FirstShape, SecondShape>::kDefined)
+	{
+		return SCollisionTest<FirstShape, SecondShape>::IsCollided(kFirst, kSecond);
+	}
+	else
+	{
+		return SCollisionTest<SecondShape, FirstShape>::IsCollided(kSecond, kFirst);
+	}
+}
+
+// Batch tests: one shape against many others of the same kind
+
+// The most shapes one mask can hold
+constexpr size_t kCollisionMaskSize = 32;
+
+// Test a shape against kCount others and return a mask with bit i set if it collided with shape i.
+// kCount must be at most kCollisionMaskSize.
+template <typename Shape, typename OtherShape>
+uint32_t GetCollidedMask(const Shape& kShape, const OtherShape* kOthers, const size_t& kCount) noexcept
+{
+	uint32_t hits = 0;
+	for (size_t i = 0; i < kCount; i++)
+	{
+		if (IsCollided(kShape, kOthers[i]))
+		{
+			hits |= 1u << i;
+		}
+	}
+	return hits;
+}
+
+// Test a shape against the others picked out by kCount indices, eg. the candidates a broadphase found.
+// Bit i of the mask is for kOthers[kIndices[i]]. kCount must be at most kCollisionMaskSize.
+template <typename Shape, typename OtherShape, typename Index>
+uint32_t GetCollidedMask(const Shape& kShape, const OtherShape* kOthers, const Index* kIndices, const size_t& kCount) noexcept
+{
+	uint32_t hits = 0;
+	for (size_t i = 0; i < kCount; i++)
+	{
+		if (IsCollided(kShape, kOthers[kIndices[i]]))
+		{
+			hits |= 1u << i;
+		}
+	}
+	return hits;
+}
+
+// Find the first of kCount shapes that a shape collides with. Returns kCount if it collides with none of them.
+template <typename Shape, typename OtherShape>
+size_t FindFirstCollided(const Shape& kShape, const OtherShape* kOthers, const size_t& kCount) noexcept
+{
+	for (size_t i = 0; i < kCount; i++)
+	{
+		if (IsCollided(kShape, kOthers[i]))
+		{
+			return i;
+		}
+	}
+	return kCount;
+}
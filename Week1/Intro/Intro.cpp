@@ -4,7 +4,7 @@
 #include "Intro.h"
 using namespace tle;
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it
 	I3DEngine* myEngine = New3DEngine(kTLX);
@@ -3,7 +3,7 @@
 #include <TL-Engine.h>	// TL-Engine include file and namespace
 using namespace tle;
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it
 	I3DEngine* myEngine = New3DEngine( kTLX );
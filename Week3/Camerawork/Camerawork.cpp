@@ -8,7 +8,7 @@ const float kCameraSpeed = 0.05f;
 const float kCameraRotation = 0.05f;
 const float kMouseRotation = 0.05f;
 
-void main()
+int main()
 {
 	// Create a 3D Engine (using TLX engine)
 	I3DEngine* myEngine = New3DEngine(kTLX);
@@ -7,7 +7,7 @@ using namespace tle;
 const double cameraSpeedMult = 0.1;
 const double moveSpeed = 0.05;
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it
 	I3DEngine* myEngine = New3DEngine( kTLX );
@@ -4,7 +4,7 @@ using namespace tle;
 // How quickly should the particle turn in degrees per second
 constexpr float speed = 0.05;
 
-void main()
+int main()
 {
 	// Create a 3D engine (using TLX engine here) and open a window for it
 	I3DEngine* myEngine = New3DEngine(kTLX);